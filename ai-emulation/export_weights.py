@@ -0,0 +1,17 @@
+import argparse
+
+import torch
+
+from modules.training_tools import export_mlp_weights
+
+parser = argparse.ArgumentParser(description="Convert a traced MLP to the native C++ weight format.")
+parser.add_argument("model", nargs="?", default="./traction_control_model/mlp_model_traced.pt",
+                    help="TorchScript model saved by save_model_for_cpp")
+parser.add_argument("output", nargs="?", default="./traction_control_model/mlp_model_traced.bin",
+                    help="Destination of the flat weight file")
+parser.add_argument("--int8", action="store_true",
+                    help="Quantize the hidden and output layers to int8 (post-training)")
+args = parser.parse_args()
+
+model = torch.jit.load(args.model, map_location="cpu")
+export_mlp_weights(model, args.output, quantize=args.int8)
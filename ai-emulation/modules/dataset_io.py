@@ -0,0 +1,236 @@
+import struct
+import numpy as np
+
+import torch
+from torch.utils.data import IterableDataset
+
+
+# Columnar dataset written by data_generator --format bin (see
+# emulation/include/ColumnarDataset.h), little-endian:
+#   header : char[4] "TCTR", uint32 version, uint32 num_columns, uint32 chunk_rows,
+#            uint64 num_rows, uint64 data_offset, byte[32] reserved
+#   column : char[32] name, float32 min, float32 max, byte[8] reserved
+#   data   : float32[num_chunks][num_columns][chunk_rows] at data_offset
+DATASET_MAGIC = b"TCTR"
+DATASET_VERSION = 2
+HEADER_BYTES = 64
+COLUMN_BYTES = 48
+NAME_BYTES = 32
+
+
+class ColumnarDataset:
+    """
+    Zero-copy view of a columnar dataset file through numpy.memmap.
+
+    Only the pages that are actually read are loaded, so files larger than
+    RAM can be used.
+
+    Args:
+        path (str): Path to a .bin dataset.
+    """
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            header = f.read(HEADER_BYTES)
+            if len(header) < HEADER_BYTES or header[:4] != DATASET_MAGIC:
+                raise ValueError(f"{path} is not a columnar dataset")
+
+            version, num_columns, chunk_rows, num_rows, data_offset = struct.unpack_from("<IIIQQ", header, 4)
+            if version != DATASET_VERSION:
+                raise ValueError(f"Unsupported dataset version {version} in {path}")
+
+            self.columns = []
+            self.min = np.empty(num_columns, dtype=np.float32)
+            self.max = np.empty(num_columns, dtype=np.float32)
+            for c in range(num_columns):
+                desc = f.read(COLUMN_BYTES)
+                self.columns.append(desc[:NAME_BYTES].split(b"\0", 1)[0].decode("ascii"))
+                self.min[c], self.max[c] = struct.unpack_from("<ff", desc, NAME_BYTES)
+
+        self.path = path
+        self.num_rows = num_rows
+        self.chunk_rows = chunk_rows
+        self.num_chunks = (num_rows + chunk_rows - 1) // chunk_rows
+        self.data = np.memmap(path, dtype="<f4", mode="r", offset=data_offset,
+                              shape=(self.num_chunks, num_columns, chunk_rows))
+
+    def column_indices(self, names):
+        return [self.columns.index(name) for name in names]
+
+    def rows_in_chunk(self, chunk):
+        return min(self.chunk_rows, self.num_rows - chunk * self.chunk_rows)
+
+    def read_chunk(self, chunk, names):
+        """
+        Return the valid rows of one chunk as a [rows, len(names)] float32 array.
+        """
+        rows = self.rows_in_chunk(chunk)
+        block = self.data[chunk, self.column_indices(names), :rows]
+        return np.ascontiguousarray(block.T)
+
+    def scaler(self, names):
+        """
+        Min-max scaler for the given columns, fitted from the header statistics.
+        """
+        indices = self.column_indices(names)
+        return HeaderMinMaxScaler(self.min[indices], self.max[indices])
+
+
+class HeaderMinMaxScaler:
+    """
+    Same transform as sklearn's MinMaxScaler, but with the ranges taken from
+    the dataset header instead of a pass over the data.
+    """
+
+    def __init__(self, data_min, data_max):
+        self.data_min_ = np.asarray(data_min, dtype=np.float64)
+        self.data_max_ = np.asarray(data_max, dtype=np.float64)
+        data_range = self.data_max_ - self.data_min_
+        self.scale_ = 1.0 / np.where(data_range == 0.0, 1.0, data_range)
+
+    def transform(self, X):
+        return (X - self.data_min_) * self.scale_
+
+    def inverse_transform(self, X):
+        return X / self.scale_ + self.data_min_
+
+
+class ChunkStreamDataset(IterableDataset):
+    """
+    Streams scaled (features, targets) mini-batches chunk by chunk.
+
+    Use with DataLoader(dataset, batch_size=None). Chunks are visited in a
+    random order each epoch and rows are shuffled within a chunk, so only one
+    chunk is resident at a time.
+
+    Args:
+        dataset (ColumnarDataset): Source file.
+        features (list[str]): Input column names.
+        targets (list[str]): Target column names.
+        chunks (list[int]): Chunk indices to read (e.g. a train or validation split).
+        batch_size (int): Rows per yielded batch.
+        shuffle (bool): Shuffle chunks and rows.
+        seed (int): Base seed for the shuffling; the epoch number is added to it.
+        row_range (tuple[int, int]): Only rows [start, stop) of each chunk, e.g.
+            to split a single-chunk file; None reads every row.
+    """
+
+    def __init__(self, dataset, features, targets, chunks, batch_size=64, shuffle=True, seed=0,
+                 row_range=None):
+        self.dataset = dataset
+        self.features = features
+        self.targets = targets
+        self.chunks = list(chunks)
+        self.batch_size = batch_size
+        self.shuffle = shuffle
+        self.seed = seed
+        self.row_range = row_range
+        self.epoch = 0
+        self.feature_scaler = dataset.scaler(features)
+        self.target_scaler = dataset.scaler(targets)
+
+    def _rows(self, chunk):
+        rows = self.dataset.rows_in_chunk(chunk)
+        if self.row_range is None:
+            return 0, rows
+        start, stop = self.row_range
+        return min(start, rows), min(stop, rows)
+
+    def __len__(self):
+        return sum(stop - start for start, stop in map(self._rows, self.chunks))
+
+    def __iter__(self):
+        rng = np.random.default_rng(self.seed + self.epoch)
+        self.epoch += 1
+
+        order = rng.permutation(self.chunks) if self.shuffle else self.chunks
+        for chunk in order:
+            start, stop = self._rows(chunk)
+            X = self.feature_scaler.transform(self.dataset.read_chunk(chunk, self.features)[start:stop])
+            y = self.target_scaler.transform(self.dataset.read_chunk(chunk, self.targets)[start:stop])
+            rows = np.arange(len(X))
+            if self.shuffle:
+                rng.shuffle(rows)
+
+            for start in range(0, len(rows), self.batch_size):
+                batch = rows[start:start + self.batch_size]
+                yield (torch.tensor(X[batch], dtype=torch.float32),
+                       torch.tensor(y[batch], dtype=torch.float32))
+
+
+class OnlineSimulationDataset(IterableDataset):
+    """
+    Streams scaled (features, targets) mini-batches simulated on the fly by the
+    tc_sim module (emulation/src/tc_python.cpp), with no file in between.
+
+    Use with DataLoader(dataset, batch_size=None). The rows are simulated
+    directly into preallocated tensors: tc_sim.fill_batch writes through
+    tensor.numpy(), which shares memory with the tensor, and the scaling is
+    done in place. With resample=True every epoch simulates fresh rows from
+    seed + epoch; otherwise the rows of the first fill are reused.
+
+    Args:
+        rows (int): Rows per epoch.
+        features (list[str]): Input column names.
+        targets (list[str]): Target column names.
+        batch_size (int): Rows per yielded batch.
+        shuffle (bool): Shuffle rows.
+        resample (bool): Simulate new rows every epoch.
+        seed (int): Simulation and shuffling seed.
+        threads (int): Simulation threads (0 = all cores); rows do not depend on it.
+        scalers (tuple): (feature_scaler, target_scaler); fitted on the first fill if None.
+    """
+
+    def __init__(self, rows, features, targets, batch_size=64, shuffle=True, resample=True,
+                 seed=0, threads=0, scalers=None):
+        import tc_sim
+
+        self.fill_batch = tc_sim.fill_batch
+        self.features = features
+        self.targets = targets
+        self.batch_size = batch_size
+        self.shuffle = shuffle
+        self.resample = resample
+        self.seed = seed
+        self.threads = threads
+        self.epoch = 0
+
+        self.X = torch.empty((rows, len(features)), dtype=torch.float32)
+        self.y = torch.empty((rows, len(targets)), dtype=torch.float32)
+        self._simulate(seed)
+
+        if scalers is None:
+            X, y = self.X.numpy(), self.y.numpy()
+            scalers = (HeaderMinMaxScaler(X.min(axis=0), X.max(axis=0)),
+                       HeaderMinMaxScaler(y.min(axis=0), y.max(axis=0)))
+        self.feature_scaler, self.target_scaler = scalers
+        self._scale()
+        self.filled_seed = seed
+
+    def __len__(self):
+        return len(self.X)
+
+    def _simulate(self, seed):
+        self.fill_batch(self.X.numpy(), self.y.numpy(), seed, self.threads, self.features, self.targets)
+
+    def _scale(self):
+        for tensor, scaler in ((self.X, self.feature_scaler), (self.y, self.target_scaler)):
+            tensor.sub_(torch.as_tensor(scaler.data_min_, dtype=torch.float32))
+            tensor.mul_(torch.as_tensor(scaler.scale_, dtype=torch.float32))
+
+    def __iter__(self):
+        seed = self.seed + self.epoch
+        self.epoch += 1
+        if self.resample and seed != self.filled_seed:
+            self._simulate(seed)
+            self._scale()
+            self.filled_seed = seed
+
+        if self.shuffle:
+            order = torch.randperm(len(self.X), generator=torch.Generator().manual_seed(seed))
+        else:
+            order = torch.arange(len(self.X))
+
+        for start in range(0, len(order), self.batch_size):
+            batch = order[start:start + self.batch_size]
+            yield self.X[batch], self.y[batch]
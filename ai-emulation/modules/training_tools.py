@@ -1,4 +1,5 @@
 import random
+import struct
 import numpy as np
 
 import torch
@@ -33,6 +34,86 @@ def save_model_for_cpp(model, input_size, path):
     traced_model.save(path)
     print(f"TorchScript model saved to {path}")
 
+    stem = path.rsplit(".", 1)[0]
+    export_mlp_weights(model, stem + ".bin")
+    export_mlp_weights(model, stem + "_int8.bin", quantize=True)
+
+
+# Flat weight file read by MlpController (C++), little-endian:
+#   header : char[4] "TCML", uint32 version, uint32 num_layers, uint32 dtype
+#   layer  : uint32 in_features, uint32 out_features, uint32 relu, uint32 layer_dtype,
+#            payload
+# With dtype 0 every layer is float32 and layer_dtype is unused (0). With dtype 1
+# each layer has its own layer_dtype. Payloads:
+#   float32 (0): float32 weight[out_features][in_features], float32 bias[out_features]
+#   int8    (1): float32 scale[out_features], int8 weight[out_features][in_features],
+#                float32 bias[out_features]      (weight = scale[o] * int8 weight)
+MLP_WEIGHTS_MAGIC = b"TCML"
+MLP_WEIGHTS_VERSION = 1
+MLP_DTYPE_FLOAT32 = 0
+MLP_DTYPE_INT8 = 1
+MLP_DTYPE_PER_LAYER = 1
+
+
+def quantize_int8(weight):
+    """
+    Symmetric per-output-row int8 quantization of a (out, in) float32 weight matrix.
+
+    Returns:
+        (np.ndarray, np.ndarray): float32 scales (out,) and int8 weights (out, in).
+    """
+    scale = np.abs(weight).max(axis=1) / 127.0
+    scale[scale == 0.0] = 1.0
+    q = np.clip(np.rint(weight / scale[:, None]), -127, 127).astype(np.int8)
+    return scale.astype(np.float32), q
+
+
+def export_mlp_weights(model, path, quantize=False, min_quantized_inputs=32):
+    """
+    Export the Linear layers of an MLP to the flat binary format used by the native C++ backend.
+
+    Works with both nn.Module and TorchScript modules, since only the state dict is read.
+    Every layer but the last is followed by a ReLU, as in MLPModel.
+
+    With quantize=True, layers with at least min_quantized_inputs inputs are stored as int8
+    (post-training, per output row) and run on the int8 kernels. Narrower layers, such as the
+    input layer of MLPModel, see raw features of very different magnitudes and stay float32.
+
+    Args:
+        model (nn.Module or torch.jit.ScriptModule): Trained MLP.
+        path (str): File path to save the weights.
+        quantize (bool): Store the wide layers as int8.
+        min_quantized_inputs (int): Narrowest layer that is quantized.
+    """
+    state = model.state_dict()
+    layers = []
+    for name, tensor in state.items():
+        if name.endswith(".weight") and tensor.dim() == 2:
+            bias = state[name[: -len("weight")] + "bias"]
+            layers.append((tensor.detach().cpu().float().contiguous(),
+                           bias.detach().cpu().float().contiguous()))
+
+    dtype = MLP_DTYPE_PER_LAYER if quantize else MLP_DTYPE_FLOAT32
+    with open(path, "wb") as f:
+        f.write(MLP_WEIGHTS_MAGIC)
+        f.write(struct.pack("<III", MLP_WEIGHTS_VERSION, len(layers), dtype))
+        for index, (weight, bias) in enumerate(layers):
+            weight = weight.numpy()
+            out_features, in_features = weight.shape
+            relu = 1 if index < len(layers) - 1 else 0
+            int8 = quantize and in_features >= min_quantized_inputs
+            f.write(struct.pack("<IIII", in_features, out_features, relu,
+                                MLP_DTYPE_INT8 if int8 else MLP_DTYPE_FLOAT32))
+            if int8:
+                scale, q = quantize_int8(weight)
+                f.write(scale.astype("<f4").tobytes())
+                f.write(q.tobytes())
+            else:
+                f.write(weight.astype("<f4").tobytes())
+            f.write(bias.numpy().astype("<f4").tobytes())
+
+    print(f"MLP weights{' (int8)' if quantize else ''} saved to {path}")
+
 
 
 def load_model(model_class, input_size, hidden_size, output_size, path):
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct InferenceCacheConfig {
+    // Cell size of every keyed input. Inputs in the same cell are snapped to
+    // its center, so they share one model evaluation.
+    float slipStep   = 0.005f;
+    float omegaStep  = 0.05f;   // rad/s
+    float speedStep  = 0.02f;   // m/s
+    float torqueStep = 0.25f;   // N·m, brake and drive
+    int   capacityLog2 = 16;    // 2^16 entries of 32 bytes
+};
+
+// Memoizes model outputs over a quantized grid of the controller inputs
+// (slip, omega, speed, brake, drive). The remaining model features are
+// derived from these or constant, so they are not part of the key.
+//
+// The table is open addressed with a short linear probe; when every slot of
+// the probe is taken, the home slot is overwritten. Because the model is
+// always evaluated at the cell center, a lookup returns the same outputs
+// whether it hits or misses, and the controller does not depend on what
+// happens to be cached.
+class InferenceCache {
+public:
+    static constexpr int kKeyInputs = 5;
+    static constexpr int kOutputs   = 2;
+    using Key = std::array<int32_t, kKeyInputs>;
+
+    explicit InferenceCache(const InferenceCacheConfig& config = InferenceCacheConfig());
+
+    // Snaps the first kKeyInputs values of a model input row to their cell
+    // center (in place) and returns the cell
+    Key quantize(float* row) const;
+
+    // Copies the cached outputs of `key` to out and returns true on a hit
+    bool lookup(const Key& key, float* out);
+    void insert(const Key& key, const float* out);
+
+    void clear();
+    void resetStats() { hitCount = missCount = 0; }
+
+    uint64_t hits() const { return hitCount; }
+    uint64_t misses() const { return missCount; }
+    double hitRate() const
+    {
+        uint64_t total = hitCount + missCount;
+        return total > 0 ? (double)hitCount / total : 0.0;
+    }
+
+    std::size_t capacity() const { return entries.size(); }
+
+private:
+    static constexpr int kProbes = 4;
+
+    struct Entry {
+        Key      key;
+        uint32_t used;
+        float    out[kOutputs];
+    };
+
+    float step[kKeyInputs];
+    float invStep[kKeyInputs];
+    std::vector<Entry> entries;
+    std::size_t mask;
+
+    uint64_t hitCount  = 0;
+    uint64_t missCount = 0;
+
+    static uint64_t hash(const Key& key);
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Native evaluator for the MLPModel written by export_mlp_weights()
+// (modules/training_tools.py). Runs the Linear/ReLU stack without libtorch.
+//
+// Weights are repacked at load time into panels of kPanel output rows,
+// laid out [panel][input][kPanel], so each input element is broadcast once
+// and multiplied against a contiguous vector of weights. Rows are processed
+// in blocks of kRowBlock to reuse every weight load across several inputs.
+//
+// Layers exported as int8 (export_mlp_weights(quantize=True)) keep their
+// weights as int8 with one float scale per output. Their inputs are
+// quantized per row (symmetric, max |x| -> 127) and the dot products run in
+// int32 with pairs of inputs per instruction (pmaddwd, or vpdpwssd with
+// AVX-512 VNNI), then are rescaled to float before the bias and ReLU.
+class MlpController {
+public:
+    bool load(const std::string& path);
+    bool isLoaded() const { return !layers.empty(); }
+
+    int inputSize() const { return layers.empty() ? 0 : layers.front().in; }
+    int outputSize() const { return layers.empty() ? 0 : layers.back().out; }
+
+    // input: rows x inputSize(), output: rows x outputSize(), both row-major
+    void forward(const float* input, float* output, int rows = 1);
+
+    // True if any layer runs on the int8 kernels
+    bool isQuantized() const;
+
+    // Bytes of weights, scales and biases as stored for the kernels
+    std::size_t weightBytes() const;
+
+    // "avx512", "avx2" or "scalar"
+    static const char* kernelName();
+
+    // Two SIMD vectors per panel keep 2 x kRowBlock independent FMA chains in
+    // flight, enough to hide the FMA latency.
+#if defined(__AVX512F__)
+    static constexpr int kPanel = 32;
+#elif defined(__AVX2__)
+    static constexpr int kPanel = 16;
+#else
+    static constexpr int kPanel = 8;
+#endif
+    static constexpr int kRowBlock = 4;
+
+private:
+    struct Layer {
+        int in;
+        int out;
+        int outPadded;              // out rounded up to kPanel
+        bool relu;
+        bool int8;
+        std::vector<float> packed;  // (outPadded / kPanel) x in x kPanel
+        std::vector<float> bias;    // outPadded
+
+        // int8 layers: (outPadded / kPanel) x inPairs x kPanel x 2, i.e. two
+        // consecutive inputs per output next to each other, zero padded
+        int inPairs;
+        std::vector<int8_t> packedInt8;
+        std::vector<float> scale;   // outPadded
+    };
+
+    std::vector<Layer> layers;
+    int maxWidth = 0;
+
+    // Activations of the current row block, ping-ponged between layers
+    std::vector<float> bufferA;
+    std::vector<float> bufferB;
+
+    // Row block quantized for an int8 layer, and the scale of every row
+    std::vector<int16_t> quantized;
+    float rowScale[kRowBlock];
+
+    static void layerForward(const Layer& layer, const float* in, int inStride,
+                             float* out, int outStride);
+    void layerForwardInt8(const Layer& layer, const float* in, int inStride,
+                          float* out, int outStride);
+};
@@ -4,6 +4,7 @@
 #include "Vehicle.h"
 #include "TractionControl.h"
 #include "Visualizer.h"
+#include "Profiler.h"
 
 class Simulation {
 public:
@@ -11,10 +12,17 @@ public:
                std::shared_ptr<TractionControl> tc,
                std::shared_ptr<Visualizer> vis);
 
+    // Prints the control/physics/render latency histograms on exit
     void run();
 
 private:
     std::shared_ptr<Vehicle> vehicle;
     std::shared_ptr<TractionControl> tractionControl;
     std::shared_ptr<Visualizer> visualizer;
+
+    Profiler profiler;
+    LatencyHistogram& controlTime;
+    LatencyHistogram& physicsTime;
+    LatencyHistogram& renderTime;
+    LatencyHistogram& frameTime;
 };
@@ -1,15 +1,46 @@
 #pragma once
 
 #include "Vehicle.h"
+#include "MlpController.h"
+#include "InferenceCache.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#ifdef TC_WITH_TORCH
 #include <torch/script.h> // Include TorchScript
 #include <torch/torch.h>
+#endif
 
 class TractionControl {
 public:
+    enum class Backend {
+        RuleBased,    // classic slip controller, no model
+        TorchScript,  // traced model through libtorch (USE_TORCH builds only)
+        Native        // exported weights evaluated by MlpController
+    };
+
+    // The backend follows the model file: ".bin" weights run on the native
+    // MLP, anything else is loaded as TorchScript. An empty path (or a model
+    // that fails to load) falls back to the rule-based controller.
     TractionControl(double desiredSlip, const std::string& modelPath);
+    TractionControl(double desiredSlip, const std::string& modelPath, Backend backend);
 
     void update(Vehicle& vehicle, double dt);
 
+    // Evaluates every wheel of every vehicle with a single forward pass.
+    // Wheels whose inference fails get the rule-based update for that step,
+    // with or without the cache.
+    void updateBatch(const std::vector<Vehicle*>& vehicles, double dt);
+
+    Backend getBackend() const { return backend; }
+
+    // Optional memoization of the model call over a quantized input grid
+    // (see InferenceCache); the model then runs only for unseen cells.
+    // No effect on the rule-based controller.
+    void enableCache(const InferenceCacheConfig& config = InferenceCacheConfig());
+    const InferenceCache* getCache() const { return cache.get(); }
+
 private:
     double desiredSlip;
     double maxBrakeTorque;
@@ -17,7 +48,42 @@ private:
     double brakeRampRate;
     double driveRampRate;
 
+    Backend backend = Backend::RuleBased;
+
+    // Model input, one row per wheel. Allocated once and only regrown when a
+    // batch has more wheels than ever before.
+    static constexpr int64_t kNumFeatures = 8;
+    int64_t inputCapacity = 0;
+
+    MlpController mlp;
+    std::vector<float> nativeInput;
+    std::vector<float> nativeOutput;
+
+    // Rows the cache could not answer, compacted for one model call
+    std::unique_ptr<InferenceCache> cache;
+    std::vector<InferenceCache::Key> missKeys;
+    std::vector<int64_t> missRows;
+    std::vector<float> missInput;
+    std::vector<float> missOutput;
+
+#ifdef TC_WITH_TORCH
     torch::jit::Module model;
-    bool modelLoaded = false;
     c10::Device device;
+    torch::Tensor hostInput;    // CPU (pinned when running on CUDA)
+    torch::Tensor deviceInput;  // same storage as hostInput on CPU
+#endif
+
+    void loadModel(const std::string& modelPath, Backend requested);
+    void updateVehicles(Vehicle* const* vehicles, size_t count, double dt);
+    void ensureCapacity(int64_t rows);
+    void packInputs(Vehicle* const* vehicles, size_t count, float* in) const;
+    void applyTorques(Vehicle* const* vehicles, size_t count, const float* out, int64_t stride) const;
+    void ruleBasedUpdate(Vehicle& vehicle, int wheelIndex, double dt);
+    void updateCached(Vehicle* const* vehicles, size_t count, int64_t rows, double dt);
+
+    // Model outputs for `rows` input rows; `stride` receives the output row length
+    bool runModel(const float* in, int64_t rows, float* out, int64_t& stride);
+#ifdef TC_WITH_TORCH
+    bool runTorch(int64_t rows, float* out);
+#endif
 };
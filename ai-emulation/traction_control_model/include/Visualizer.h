@@ -1,21 +1,73 @@
 #pragma once
 
 #include <SDL.h>
+#include <vector>
 #include "Vehicle.h"
 
 class Visualizer {
 public:
-    Visualizer();
+    // With vsync, presenting a frame waits for the display refresh, which
+    // paces the render loop; without it (or if the driver refuses) the
+    // caller has to pace itself, see hasVsync()
+    explicit Visualizer(bool vsync = true);
     ~Visualizer();
 
-    bool isRunning() const;
-    void render(const Vehicle& vehicle);
+    // Handles window events; false once the window was closed
+    bool isRunning();
+
+    // Draws one vehicle, or several side by side in a grid of tiles. Returns
+    // false if the frame was skipped (see setFrameSkip) and nothing was
+    // presented.
+    bool render(const Vehicle& vehicle);
+    bool render(const std::vector<Vehicle>& vehicles);
+
+    bool hasVsync() const { return vsync; }
+
+    // Draw only one of every (frames + 1) render() calls
+    void setFrameSkip(int frames) { frameSkip = frames > 0 ? frames : 0; }
+
+    // True once after P was pressed (print the latency report)
+    bool takeReportRequest()
+    {
+        bool requested = reportRequested;
+        reportRequested = false;
+        return requested;
+    }
 
 private:
+    // Textured quad: a source rectangle of a texture drawn to dst
+    struct Sprite {
+        SDL_Rect src;
+        SDL_Rect dst;
+    };
+
     SDL_Window* window;
     SDL_Renderer* renderer;
+    SDL_Texture* carTexture = nullptr;    // car body, drawn once at startup
+    SDL_Texture* wheelTexture = nullptr;  // tire with tread grooves, scrolled as it turns
+    bool vsync = false;
+    int frameSkip = 0;
+    long long frameCounter = 0;
+    bool reportRequested = false;
+
+    // One batch per color or texture, refilled every frame (the storage is reused)
+    std::vector<SDL_Rect> speedBars;
+    std::vector<SDL_Rect> wheelSpeedBars;
+    std::vector<SDL_Rect> slipBars;
+    std::vector<Sprite> cars;
+    std::vector<Sprite> wheels;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+#endif
+
+    bool renderAll(const Vehicle* vehicles, int count);
+    void createTextures();
 
-    void drawCarAndWheels(const Vehicle& vehicle);
+    // Queue a vehicle's car, wheels and bars, laid out in `tile`
+    void addCarAndWheels(const Vehicle& vehicle, const SDL_Rect& tile);
+    void addBarGraphs(const Vehicle& vehicle, const SDL_Rect& tile);
 
-    void drawBarGraphs(const Vehicle& vehicle);
+    void fillRects(const std::vector<SDL_Rect>& rects, Uint8 r, Uint8 g, Uint8 b);
+    void drawSprites(SDL_Texture* texture, const std::vector<Sprite>& sprites);
 };
@@ -0,0 +1,84 @@
+#include "InferenceCache.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Cells further out than this are clamped (and NaN goes to cell 0)
+const float kMaxCell = 1.0e9f;
+
+} // namespace
+
+InferenceCache::InferenceCache(const InferenceCacheConfig& config)
+    : step{config.slipStep, config.omegaStep, config.speedStep, config.torqueStep, config.torqueStep}
+{
+    for (int i = 0; i < kKeyInputs; i++) {
+        invStep[i] = 1.0f / step[i];
+    }
+    int bits = std::min(std::max(config.capacityLog2, kProbes), 28);
+    entries.assign((std::size_t)1 << bits, Entry{});
+    mask = entries.size() - 1;
+}
+
+InferenceCache::Key InferenceCache::quantize(float* row) const
+{
+    Key key;
+    for (int i = 0; i < kKeyInputs; i++) {
+        float cell = std::nearbyint(row[i] * invStep[i]);
+        if (!(cell > -kMaxCell)) cell = (cell < 0.0f) ? -kMaxCell : 0.0f;
+        if (cell > kMaxCell) cell = kMaxCell;
+        key[i] = (int32_t)cell;
+        row[i] = cell * step[i];
+    }
+    return key;
+}
+
+uint64_t InferenceCache::hash(const Key& key)
+{
+    // FNV-1a over the cells, then a multiplicative mix for the low bits
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (int32_t cell : key) {
+        h = (h ^ (uint32_t)cell) * 0x100000001b3ull;
+    }
+    return (h ^ (h >> 29)) * 0xbf58476d1ce4e5b9ull;
+}
+
+bool InferenceCache::lookup(const Key& key, float* out)
+{
+    std::size_t home = hash(key) & mask;
+    for (int p = 0; p < kProbes; p++) {
+        const Entry& e = entries[(home + p) & mask];
+        if (!e.used) break;
+        if (e.key == key) {
+            std::copy_n(e.out, kOutputs, out);
+            hitCount++;
+            return true;
+        }
+    }
+    missCount++;
+    return false;
+}
+
+void InferenceCache::insert(const Key& key, const float* out)
+{
+    std::size_t home = hash(key) & mask;
+    std::size_t slot = home;
+    for (int p = 0; p < kProbes; p++) {
+        std::size_t s = (home + p) & mask;
+        if (!entries[s].used || entries[s].key == key) {
+            slot = s;
+            break;
+        }
+    }
+
+    Entry& e = entries[slot];
+    e.key  = key;
+    e.used = 1;
+    std::copy_n(out, kOutputs, e.out);
+}
+
+void InferenceCache::clear()
+{
+    std::fill(entries.begin(), entries.end(), Entry{});
+    resetStats();
+}
@@ -0,0 +1,456 @@
+#include "MlpController.h"
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const char kMagic[4] = {'T', 'C', 'M', 'L'};
+const uint32_t kVersion = 1;
+const uint32_t kDtypeFloat32 = 0;
+const uint32_t kDtypeInt8 = 1;
+const uint32_t kDtypePerLayer = 1;  // header: every layer names its own dtype
+
+bool readU32(std::ifstream& file, uint32_t& value)
+{
+    unsigned char bytes[4];
+    if (!file.read(reinterpret_cast<char*>(bytes), 4)) return false;
+    value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+    return true;
+}
+
+bool readFloats(std::ifstream& file, float* data, size_t count)
+{
+    // The format is little-endian, as is every platform we build for
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(data), count * sizeof(float)));
+}
+
+// Two consecutive int16 inputs as one 32-bit word, for pmaddwd
+inline int32_t inputPair(const int16_t* q, int pair)
+{
+    int32_t value;
+    std::memcpy(&value, q + 2 * pair, sizeof(value));
+    return value;
+}
+
+// Symmetric int8 quantization of one row (max |x| -> 127) into int16
+// slots; returns the scale back to float. Rounds to nearest even on every
+// path, so the kernels agree exactly.
+float quantizeRow(const float* x, int n, int16_t* q)
+{
+    int k = 0;
+    float maxAbs = 0.0f;
+#if defined(__AVX512F__)
+    __m512 m16 = _mm512_setzero_ps();
+    for (; k + 16 <= n; k += 16) {
+        m16 = _mm512_max_ps(m16, _mm512_abs_ps(_mm512_loadu_ps(x + k)));
+    }
+    maxAbs = _mm512_reduce_max_ps(m16);
+#elif defined(__AVX2__)
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    __m256 m8 = _mm256_setzero_ps();
+    for (; k + 8 <= n; k += 8) {
+        m8 = _mm256_max_ps(m8, _mm256_andnot_ps(signMask, _mm256_loadu_ps(x + k)));
+    }
+    float lanes[8];
+    _mm256_storeu_ps(lanes, m8);
+    for (float lane : lanes) maxAbs = std::max(maxAbs, lane);
+#endif
+    for (; k < n; k++) {
+        maxAbs = std::max(maxAbs, std::fabs(x[k]));
+    }
+
+    const float inv = (maxAbs > 0.0f) ? 127.0f / maxAbs : 0.0f;
+    k = 0;
+#if defined(__AVX512F__)
+    const __m512 inv16 = _mm512_set1_ps(inv);
+    for (; k + 16 <= n; k += 16) {
+        __m512i i32 = _mm512_cvtps_epi32(_mm512_mul_ps(_mm512_loadu_ps(x + k), inv16));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(q + k), _mm512_cvtepi32_epi16(i32));
+    }
+#elif defined(__AVX2__)
+    const __m256 inv8 = _mm256_set1_ps(inv);
+    for (; k + 8 <= n; k += 8) {
+        __m256i i32 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(x + k), inv8));
+        __m128i i16 = _mm_packs_epi32(_mm256_castsi256_si128(i32), _mm256_extracti128_si256(i32, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(q + k), i16);
+    }
+#endif
+    for (; k < n; k++) {
+        q[k] = (int16_t)std::lrint(x[k] * inv);
+    }
+    return maxAbs / 127.0f;
+}
+
+#if defined(__AVX512BW__)
+inline __m512i dot512(__m512i acc, __m512i x, __m512i w)
+{
+#if defined(__AVX512VNNI__)
+    return _mm512_dpwssd_epi32(acc, x, w);
+#else
+    return _mm512_add_epi32(acc, _mm512_madd_epi16(x, w));
+#endif
+}
+#endif
+
+#if defined(__AVX2__) && !defined(__AVX512F__)
+inline __m256 madd256(__m256 a, __m256 b, __m256 c)
+{
+#if defined(__FMA__)
+    return _mm256_fmadd_ps(a, b, c);
+#else
+    return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+#endif
+
+} // namespace
+
+bool MlpController::load(const std::string& path)
+{
+    layers.clear();
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Error opening MLP weights: " << path << std::endl;
+        return false;
+    }
+
+    char magic[4];
+    uint32_t version = 0, numLayers = 0, dtype = 0;
+    if (!file.read(magic, 4) || std::memcmp(magic, kMagic, 4) != 0 ||
+        !readU32(file, version) || !readU32(file, numLayers) || !readU32(file, dtype)) {
+        std::cerr << "Invalid MLP weights header: " << path << std::endl;
+        return false;
+    }
+    if (version != kVersion || (dtype != kDtypeFloat32 && dtype != kDtypePerLayer)) {
+        std::cerr << "Unsupported MLP weights version " << version
+                  << " / dtype " << dtype << ": " << path << std::endl;
+        return false;
+    }
+
+    std::vector<Layer> loaded;
+    std::vector<float> weights;
+    maxWidth = 0;
+
+    for (uint32_t l = 0; l < numLayers; l++) {
+        uint32_t in = 0, out = 0, relu = 0, layerDtype = 0;
+        if (!readU32(file, in) || !readU32(file, out) || !readU32(file, relu) || !readU32(file, layerDtype) ||
+            in == 0 || out == 0 || (!loaded.empty() && (int)in != loaded.back().out) ||
+            (dtype == kDtypePerLayer && layerDtype != kDtypeFloat32 && layerDtype != kDtypeInt8)) {
+            std::cerr << "Invalid layer " << l << " in MLP weights: " << path << std::endl;
+            return false;
+        }
+
+        Layer layer;
+        layer.in        = (int)in;
+        layer.out       = (int)out;
+        layer.outPadded = (int)((out + kPanel - 1) / kPanel) * kPanel;
+        layer.relu      = relu != 0;
+        layer.int8      = dtype == kDtypePerLayer && layerDtype == kDtypeInt8;
+        layer.inPairs   = (int)(in + 1) / 2;
+        layer.bias.assign(layer.outPadded, 0.0f);
+
+        if (layer.int8) {
+            std::vector<int8_t> quantizedWeights((size_t)out * in);
+            layer.scale.assign(layer.outPadded, 0.0f);
+            if (!readFloats(file, layer.scale.data(), out) ||
+                !file.read(reinterpret_cast<char*>(quantizedWeights.data()), quantizedWeights.size()) ||
+                !readFloats(file, layer.bias.data(), out)) {
+                std::cerr << "Truncated MLP weights: " << path << std::endl;
+                return false;
+            }
+
+            // Repack [out][in] into [panel][in / 2][kPanel][2], zero padded
+            layer.packedInt8.assign((size_t)layer.outPadded * layer.inPairs * 2, 0);
+            for (int o = 0; o < layer.out; o++) {
+                int panel = o / kPanel;
+                int lane  = o % kPanel;
+                for (int k = 0; k < layer.in; k++) {
+                    size_t slot = ((size_t)panel * layer.inPairs + k / 2) * kPanel + lane;
+                    layer.packedInt8[slot * 2 + k % 2] = quantizedWeights[(size_t)o * in + k];
+                }
+            }
+
+            maxWidth = std::max({maxWidth, 2 * layer.inPairs, layer.outPadded});
+            loaded.push_back(std::move(layer));
+            continue;
+        }
+
+        weights.resize((size_t)out * in);
+        if (!readFloats(file, weights.data(), weights.size()) ||
+            !readFloats(file, layer.bias.data(), out)) {
+            std::cerr << "Truncated MLP weights: " << path << std::endl;
+            return false;
+        }
+
+        // Repack row-major [out][in] into [panel][in][kPanel], zero padded
+        layer.packed.assign((size_t)layer.outPadded * in, 0.0f);
+        for (int o = 0; o < layer.out; o++) {
+            int panel = o / kPanel;
+            int lane  = o % kPanel;
+            for (int k = 0; k < layer.in; k++) {
+                layer.packed[((size_t)panel * layer.in + k) * kPanel + lane] = weights[(size_t)o * in + k];
+            }
+        }
+
+        maxWidth = std::max({maxWidth, layer.in, layer.outPadded});
+        loaded.push_back(std::move(layer));
+    }
+
+    if (loaded.empty()) {
+        std::cerr << "MLP weights contain no layers: " << path << std::endl;
+        return false;
+    }
+
+    layers = std::move(loaded);
+    bufferA.assign((size_t)kRowBlock * maxWidth, 0.0f);
+    bufferB.assign((size_t)kRowBlock * maxWidth, 0.0f);
+    quantized.assign((size_t)kRowBlock * maxWidth, 0);
+    return true;
+}
+
+bool MlpController::isQuantized() const
+{
+    return std::any_of(layers.begin(), layers.end(), [](const Layer& layer) { return layer.int8; });
+}
+
+std::size_t MlpController::weightBytes() const
+{
+    std::size_t bytes = 0;
+    for (const auto& layer : layers) {
+        bytes += (layer.packed.size() + layer.bias.size() + layer.scale.size()) * sizeof(float) +
+                 layer.packedInt8.size();
+    }
+    return bytes;
+}
+
+const char* MlpController::kernelName()
+{
+#if defined(__AVX512F__)
+    return "avx512";
+#elif defined(__AVX2__)
+    return "avx2";
+#else
+    return "scalar";
+#endif
+}
+
+void MlpController::forward(const float* input, float* output, int rows)
+{
+    if (layers.empty()) return;
+
+    const int inSize  = inputSize();
+    const int outSize = outputSize();
+
+    for (int row = 0; row < rows; row += kRowBlock) {
+        int count = std::min(kRowBlock, rows - row);
+
+        // Stage the block; missing rows stay zero and are discarded at the end
+        std::fill(bufferA.begin(), bufferA.end(), 0.0f);
+        for (int r = 0; r < count; r++) {
+            std::copy_n(input + (size_t)(row + r) * inSize, inSize, &bufferA[(size_t)r * maxWidth]);
+        }
+
+        float* src = bufferA.data();
+        float* dst = bufferB.data();
+        for (const auto& layer : layers) {
+            if (layer.int8) {
+                layerForwardInt8(layer, src, maxWidth, dst, maxWidth);
+            } else {
+                layerForward(layer, src, maxWidth, dst, maxWidth);
+            }
+            std::swap(src, dst);
+        }
+
+        for (int r = 0; r < count; r++) {
+            std::copy_n(src + (size_t)r * maxWidth, outSize, output + (size_t)(row + r) * outSize);
+        }
+    }
+}
+
+void MlpController::layerForward(const Layer& layer, const float* in, int inStride,
+                                 float* out, int outStride)
+{
+    const int panels = layer.outPadded / kPanel;
+
+    for (int p = 0; p < panels; p++) {
+        const float* w    = &layer.packed[(size_t)p * layer.in * kPanel];
+        const float* bias = &layer.bias[(size_t)p * kPanel];
+
+#if defined(__AVX512F__)
+        // Row loop written out so all eight accumulators stay in registers
+        const float* x0 = in;
+        const float* x1 = in + inStride;
+        const float* x2 = in + 2 * (size_t)inStride;
+        const float* x3 = in + 3 * (size_t)inStride;
+        __m512 a0 = _mm512_loadu_ps(bias), b0 = _mm512_loadu_ps(bias + 16);
+        __m512 a1 = a0, b1 = b0, a2 = a0, b2 = b0, a3 = a0, b3 = b0;
+        for (int k = 0; k < layer.in; k++) {
+            __m512 w0 = _mm512_loadu_ps(w + (size_t)k * kPanel);
+            __m512 w1 = _mm512_loadu_ps(w + (size_t)k * kPanel + 16);
+            __m512 x;
+            x = _mm512_set1_ps(x0[k]); a0 = _mm512_fmadd_ps(x, w0, a0); b0 = _mm512_fmadd_ps(x, w1, b0);
+            x = _mm512_set1_ps(x1[k]); a1 = _mm512_fmadd_ps(x, w0, a1); b1 = _mm512_fmadd_ps(x, w1, b1);
+            x = _mm512_set1_ps(x2[k]); a2 = _mm512_fmadd_ps(x, w0, a2); b2 = _mm512_fmadd_ps(x, w1, b2);
+            x = _mm512_set1_ps(x3[k]); a3 = _mm512_fmadd_ps(x, w0, a3); b3 = _mm512_fmadd_ps(x, w1, b3);
+        }
+        __m512 results[8] = {a0, b0, a1, b1, a2, b2, a3, b3};
+        for (int r = 0; r < kRowBlock; r++) {
+            for (int h = 0; h < 2; h++) {
+                __m512 v = results[2 * r + h];
+                if (layer.relu) v = _mm512_max_ps(v, _mm512_setzero_ps());
+                _mm512_storeu_ps(out + (size_t)r * outStride + p * kPanel + h * 16, v);
+            }
+        }
+#elif defined(__AVX2__)
+        // Row loop written out so all eight accumulators stay in registers
+        const float* x0 = in;
+        const float* x1 = in + inStride;
+        const float* x2 = in + 2 * (size_t)inStride;
+        const float* x3 = in + 3 * (size_t)inStride;
+        __m256 a0 = _mm256_loadu_ps(bias), b0 = _mm256_loadu_ps(bias + 8);
+        __m256 a1 = a0, b1 = b0, a2 = a0, b2 = b0, a3 = a0, b3 = b0;
+        for (int k = 0; k < layer.in; k++) {
+            __m256 w0 = _mm256_loadu_ps(w + (size_t)k * kPanel);
+            __m256 w1 = _mm256_loadu_ps(w + (size_t)k * kPanel + 8);
+            __m256 x;
+            x = _mm256_set1_ps(x0[k]); a0 = madd256(x, w0, a0); b0 = madd256(x, w1, b0);
+            x = _mm256_set1_ps(x1[k]); a1 = madd256(x, w0, a1); b1 = madd256(x, w1, b1);
+            x = _mm256_set1_ps(x2[k]); a2 = madd256(x, w0, a2); b2 = madd256(x, w1, b2);
+            x = _mm256_set1_ps(x3[k]); a3 = madd256(x, w0, a3); b3 = madd256(x, w1, b3);
+        }
+        __m256 results[8] = {a0, b0, a1, b1, a2, b2, a3, b3};
+        for (int r = 0; r < kRowBlock; r++) {
+            for (int h = 0; h < 2; h++) {
+                __m256 v = results[2 * r + h];
+                if (layer.relu) v = _mm256_max_ps(v, _mm256_setzero_ps());
+                _mm256_storeu_ps(out + (size_t)r * outStride + p * kPanel + h * 8, v);
+            }
+        }
+#else
+        float acc[kRowBlock][kPanel];
+        for (int r = 0; r < kRowBlock; r++) {
+            std::copy_n(bias, kPanel, acc[r]);
+        }
+        for (int k = 0; k < layer.in; k++) {
+            const float* wk = w + (size_t)k * kPanel;
+            for (int r = 0; r < kRowBlock; r++) {
+                float x = in[(size_t)r * inStride + k];
+                for (int j = 0; j < kPanel; j++) {
+                    acc[r][j] += x * wk[j];
+                }
+            }
+        }
+        for (int r = 0; r < kRowBlock; r++) {
+            for (int j = 0; j < kPanel; j++) {
+                float v = acc[r][j];
+                out[(size_t)r * outStride + p * kPanel + j] = (layer.relu && v < 0.0f) ? 0.0f : v;
+            }
+        }
+#endif
+    }
+}
+
+void MlpController::layerForwardInt8(const Layer& layer, const float* in, int inStride,
+                                     float* out, int outStride)
+{
+    // Quantize the block, one symmetric scale per row
+    const int qStride = 2 * layer.inPairs;
+    for (int r = 0; r < kRowBlock; r++) {
+        int16_t* q = &quantized[(size_t)r * qStride];
+        rowScale[r] = quantizeRow(in + (size_t)r * inStride, layer.in, q);
+        if (layer.in < qStride) q[layer.in] = 0;
+    }
+
+    const int16_t* q0 = quantized.data();
+    const int16_t* q1 = q0 + qStride;
+    const int16_t* q2 = q0 + 2 * (size_t)qStride;
+    const int16_t* q3 = q0 + 3 * (size_t)qStride;
+    const int panels = layer.outPadded / kPanel;
+
+    for (int p = 0; p < panels; p++) {
+        const int8_t* w    = &layer.packedInt8[(size_t)p * layer.inPairs * kPanel * 2];
+        const float* scale = &layer.scale[(size_t)p * kPanel];
+        const float* bias  = &layer.bias[(size_t)p * kPanel];
+
+#if defined(__AVX512BW__)
+        // Each 32-byte load holds 16 outputs x 2 inputs
+        __m512i a0 = _mm512_setzero_si512(), b0 = a0, a1 = a0, b1 = a0, a2 = a0, b2 = a0, a3 = a0, b3 = a0;
+        for (int k = 0; k < layer.inPairs; k++) {
+            const int8_t* wk = w + (size_t)k * kPanel * 2;
+            __m512i w0 = _mm512_cvtepi8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(wk)));
+            __m512i w1 = _mm512_cvtepi8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(wk + 32)));
+            __m512i x;
+            x = _mm512_set1_epi32(inputPair(q0, k)); a0 = dot512(a0, x, w0); b0 = dot512(b0, x, w1);
+            x = _mm512_set1_epi32(inputPair(q1, k)); a1 = dot512(a1, x, w0); b1 = dot512(b1, x, w1);
+            x = _mm512_set1_epi32(inputPair(q2, k)); a2 = dot512(a2, x, w0); b2 = dot512(b2, x, w1);
+            x = _mm512_set1_epi32(inputPair(q3, k)); a3 = dot512(a3, x, w0); b3 = dot512(b3, x, w1);
+        }
+        __m512i results[8] = {a0, b0, a1, b1, a2, b2, a3, b3};
+        for (int r = 0; r < kRowBlock; r++) {
+            for (int h = 0; h < 2; h++) {
+                __m512 s = _mm512_mul_ps(_mm512_loadu_ps(scale + h * 16), _mm512_set1_ps(rowScale[r]));
+                __m512 v = _mm512_add_ps(_mm512_mul_ps(_mm512_cvtepi32_ps(results[2 * r + h]), s),
+                                         _mm512_loadu_ps(bias + h * 16));
+                if (layer.relu) v = _mm512_max_ps(v, _mm512_setzero_ps());
+                _mm512_storeu_ps(out + (size_t)r * outStride + p * kPanel + h * 16, v);
+            }
+        }
+#elif defined(__AVX2__) && !defined(__AVX512F__)
+        // Each 16-byte load holds 8 outputs x 2 inputs
+        __m256i a0 = _mm256_setzero_si256(), b0 = a0, a1 = a0, b1 = a0, a2 = a0, b2 = a0, a3 = a0, b3 = a0;
+        for (int k = 0; k < layer.inPairs; k++) {
+            const int8_t* wk = w + (size_t)k * kPanel * 2;
+            __m256i w0 = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(wk)));
+            __m256i w1 = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(wk + 16)));
+            __m256i x;
+            x = _mm256_set1_epi32(inputPair(q0, k));
+            a0 = _mm256_add_epi32(a0, _mm256_madd_epi16(x, w0)); b0 = _mm256_add_epi32(b0, _mm256_madd_epi16(x, w1));
+            x = _mm256_set1_epi32(inputPair(q1, k));
+            a1 = _mm256_add_epi32(a1, _mm256_madd_epi16(x, w0)); b1 = _mm256_add_epi32(b1, _mm256_madd_epi16(x, w1));
+            x = _mm256_set1_epi32(inputPair(q2, k));
+            a2 = _mm256_add_epi32(a2, _mm256_madd_epi16(x, w0)); b2 = _mm256_add_epi32(b2, _mm256_madd_epi16(x, w1));
+            x = _mm256_set1_epi32(inputPair(q3, k));
+            a3 = _mm256_add_epi32(a3, _mm256_madd_epi16(x, w0)); b3 = _mm256_add_epi32(b3, _mm256_madd_epi16(x, w1));
+        }
+        __m256i results[8] = {a0, b0, a1, b1, a2, b2, a3, b3};
+        for (int r = 0; r < kRowBlock; r++) {
+            for (int h = 0; h < 2; h++) {
+                __m256 s = _mm256_mul_ps(_mm256_loadu_ps(scale + h * 8), _mm256_set1_ps(rowScale[r]));
+                __m256 v = _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(results[2 * r + h]), s),
+                                         _mm256_loadu_ps(bias + h * 8));
+                if (layer.relu) v = _mm256_max_ps(v, _mm256_setzero_ps());
+                _mm256_storeu_ps(out + (size_t)r * outStride + p * kPanel + h * 8, v);
+            }
+        }
+#else
+        const int16_t* rows[kRowBlock] = {q0, q1, q2, q3};
+        int32_t acc[kRowBlock][kPanel] = {};
+        for (int k = 0; k < layer.inPairs; k++) {
+            const int8_t* wk = w + (size_t)k * kPanel * 2;
+            for (int r = 0; r < kRowBlock; r++) {
+                int32_t x0 = rows[r][2 * k];
+                int32_t x1 = rows[r][2 * k + 1];
+                for (int j = 0; j < kPanel; j++) {
+                    acc[r][j] += x0 * wk[2 * j] + x1 * wk[2 * j + 1];
+                }
+            }
+        }
+        for (int r = 0; r < kRowBlock; r++) {
+            for (int j = 0; j < kPanel; j++) {
+                float s = scale[j] * rowScale[r];
+                float v = (float)acc[r][j] * s + bias[j];
+                out[(size_t)r * outStride + p * kPanel + j] = (layer.relu && v < 0.0f) ? 0.0f : v;
+            }
+        }
+#endif
+    }
+}
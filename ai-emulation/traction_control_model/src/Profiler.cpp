@@ -0,0 +1,119 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+int highestBit(uint64_t value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return (int)index;
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+// Nanoseconds -> microseconds
+double micros(int64_t nanos)
+{
+    return nanos * 1e-3;
+}
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram(std::string name_, double deadlineSeconds)
+    : name(std::move(name_)),
+      deadlineNanos(deadlineSeconds > 0.0 ? (int64_t)std::llround(deadlineSeconds * 1e9) : 0)
+{
+    for (auto& c : counts) {
+        c.store(0, std::memory_order_relaxed);
+    }
+}
+
+int LatencyHistogram::bucketIndex(uint64_t value)
+{
+    if (value < (uint64_t)kSubBuckets) {
+        return (int)value;
+    }
+    // value >> shift lands in [kSubBuckets / 2, kSubBuckets)
+    int shift = highestBit(value) - kSubBucketBits + 1;
+    int sub = (int)(value >> shift) - kSubBuckets / 2;
+    return kSubBuckets + (shift - 1) * (kSubBuckets / 2) + sub;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(int index)
+{
+    if (index < kSubBuckets) {
+        return (uint64_t)index;
+    }
+    int k = index - kSubBuckets;
+    int shift = k / (kSubBuckets / 2) + 1;
+    uint64_t sub = (uint64_t)(k % (kSubBuckets / 2) + kSubBuckets / 2);
+    return ((sub + 1) << shift) - 1;
+}
+
+int64_t LatencyHistogram::percentileNanos(double quantile) const
+{
+    uint64_t n = getCount();
+    if (n == 0) return 0;
+
+    uint64_t rank = (uint64_t)std::ceil(std::clamp(quantile, 0.0, 1.0) * n);
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t seen = 0;
+    for (int i = 0; i < kNumBuckets; i++) {
+        seen += counts[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return std::min((int64_t)bucketUpperBound(i), getMaxNanos());
+        }
+    }
+    return getMaxNanos();
+}
+
+LatencyHistogram& Profiler::add(const std::string& name, double deadlineSeconds)
+{
+    histograms.push_back(std::make_unique<LatencyHistogram>(name, deadlineSeconds));
+    return *histograms.back();
+}
+
+void Profiler::report(std::ostream& out) const
+{
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    out << std::left << std::setw(10) << "phase" << std::right
+        << std::setw(10) << "count"
+        << std::setw(12) << "p50 us"
+        << std::setw(12) << "p99 us"
+        << std::setw(12) << "p99.9 us"
+        << std::setw(12) << "max us"
+        << std::setw(14) << "deadline us"
+        << std::setw(10) << "misses" << '\n';
+
+    out << std::fixed << std::setprecision(2);
+    for (const auto& h : histograms) {
+        out << std::left << std::setw(10) << h->getName() << std::right
+            << std::setw(10) << h->getCount()
+            << std::setw(12) << micros(h->percentileNanos(0.50))
+            << std::setw(12) << micros(h->percentileNanos(0.99))
+            << std::setw(12) << micros(h->percentileNanos(0.999))
+            << std::setw(12) << micros(h->getMaxNanos());
+        if (h->getDeadlineSeconds() > 0.0) {
+            out << std::setw(14) << h->getDeadlineSeconds() * 1e6
+                << std::setw(10) << h->getDeadlineMisses();
+        } else {
+            out << std::setw(14) << "-" << std::setw(10) << "-";
+        }
+        out << '\n';
+    }
+    out.flush();
+
+    out.flags(flags);
+    out.precision(precision);
+}
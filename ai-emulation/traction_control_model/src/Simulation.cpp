@@ -3,46 +3,66 @@
 #include <chrono>
 #include <iostream>
 
+namespace {
+
+const double kPhysicsDt = 0.01;          // 10 ms
+const double kFrameSeconds = 1.0 / 60;   // render pace without vsync
+const double kMinVsyncFrame = 1.0 / 240; // cap if "vsync" does not block (e.g. minimized)
+
+} // namespace
+
 Simulation::Simulation(std::shared_ptr<Vehicle> vehicle,
                        std::shared_ptr<TractionControl> tc,
                        std::shared_ptr<Visualizer> vis)
     : vehicle(std::move(vehicle)),
     tractionControl(std::move(tc)),
-    visualizer(std::move(vis))
+    visualizer(std::move(vis)),
+    // The controller has to fit in the 10 ms physics step
+    controlTime(profiler.add("control", kPhysicsDt)),
+    physicsTime(profiler.add("physics", kPhysicsDt)),
+    renderTime(profiler.add("render")),
+    frameTime(profiler.add("frame"))
 {}
 
 void Simulation::run()
 {
     using clock = std::chrono::steady_clock;
 
-    const double physicsDt = 0.01; // 10 ms
+    const double physicsDt = kPhysicsDt;
     double accumulator = 0.0;
 
+    const auto framePeriod = std::chrono::duration_cast<clock::duration>(
+        std::chrono::duration<double>(kFrameSeconds));
+    const auto vsyncPeriod = std::chrono::duration_cast<clock::duration>(
+        std::chrono::duration<double>(kMinVsyncFrame));
+
     auto prevTime = clock::now();
+    auto nextFrame = prevTime;
 
     while (visualizer->isRunning()) {
         // 1) Measure elapsed time in seconds
         auto currentTime = clock::now();
-        double frameTime = std::chrono::duration<double>(currentTime - prevTime).count();
+        auto elapsed = currentTime - prevTime;
         prevTime = currentTime;
-
-        // Debugging: Log frame timing
-        std::cout << "Frame Time: " << frameTime << " seconds" << std::endl;
+        frameTime.record(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
 
         // 2) Accumulate time
-        accumulator += frameTime;
+        accumulator += std::chrono::duration<double>(elapsed).count();
 
         // 3) While we have enough time accumulated for a physics step
         while (accumulator >= physicsDt) {
             try {
                 // A) Update traction control => sets torque
-                tractionControl->update(*vehicle, physicsDt);
-
-                // Debugging: Log vehicle state
-                std::cout << "Vehicle Linear Speed: " << vehicle->getLinearSpeed() << " m/s" << std::endl;
+                {
+                    ScopedTimer timer(controlTime);
+                    tractionControl->update(*vehicle, physicsDt);
+                }
 
                 // B) Advance vehicle physics
-                vehicle->update(physicsDt);
+                {
+                    ScopedTimer timer(physicsTime);
+                    vehicle->update(physicsDt);
+                }
 
                 accumulator -= physicsDt;
             } catch (const std::exception& e) {
@@ -51,13 +71,27 @@ void Simulation::run()
         }
 
         // 4) Render once per loop
+        bool presented = false;
         try {
-            visualizer->render(*vehicle);
+            ScopedTimer timer(renderTime);
+            presented = visualizer->render(*vehicle);
         } catch (const std::exception& e) {
             std::cerr << "Exception during rendering: " << e.what() << std::endl;
         }
+        if (visualizer->takeReportRequest()) {
+            profiler.report(std::cout);
+        }
 
-        // 5) Sleep a bit to limit CPU usage (e.g. ~20-30 fps render)
-        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        // 5) Pace the loop; with vsync, presenting already waited for the display
+        nextFrame += (presented && visualizer->hasVsync()) ? vsyncPeriod : framePeriod;
+        auto now = clock::now();
+        if (nextFrame < now) {
+            nextFrame = now;  // rendering fell behind; don't try to catch up
+        } else {
+            std::this_thread::sleep_until(nextFrame);
+        }
     }
+
+    std::cout << "Final speed: " << vehicle->getLinearSpeed() << " m/s" << std::endl;
+    profiler.report(std::cout);
 }
\ No newline at end of file
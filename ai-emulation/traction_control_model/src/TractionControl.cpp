@@ -3,9 +3,32 @@
 #include <cmath>
 #include <iostream>
 
+namespace {
+
+TractionControl::Backend backendForPath(const std::string& modelPath)
+{
+    if (modelPath.empty()) {
+        return TractionControl::Backend::RuleBased;
+    }
+    const std::string ext = ".bin";
+    if (modelPath.size() >= ext.size() &&
+        modelPath.compare(modelPath.size() - ext.size(), ext.size(), ext) == 0) {
+        return TractionControl::Backend::Native;
+    }
+    return TractionControl::Backend::TorchScript;
+}
+
+} // namespace
+
 TractionControl::TractionControl(double desiredSlip_, const std::string& modelPath)
-    : desiredSlip(desiredSlip_),
-      device(torch::cuda::is_available() ? torch::kCUDA : torch::kCPU)
+    : TractionControl(desiredSlip_, modelPath, backendForPath(modelPath))
+{}
+
+TractionControl::TractionControl(double desiredSlip_, const std::string& modelPath, Backend requested)
+    : desiredSlip(desiredSlip_)
+#ifdef TC_WITH_TORCH
+    , device(torch::cuda::is_available() ? torch::kCUDA : torch::kCPU)
+#endif
 {
     maxBrakeTorque = 200.0;   // N·m
     maxDriveTorque = 150.0;   // N·m
@@ -13,10 +36,37 @@ TractionControl::TractionControl(double desiredSlip_, const std::string& modelPa
     driveRampRate  = 300.0;   // N·m per second
 
     if (!modelPath.empty()) {
+        loadModel(modelPath, requested);
+    }
+
+    // Room for one 4-wheel vehicle; larger batches grow the buffers once
+    ensureCapacity(4);
+}
+
+void TractionControl::loadModel(const std::string& modelPath, Backend requested)
+{
+    if (requested == Backend::Native) {
+        if (mlp.load(modelPath)) {
+            if (mlp.inputSize() != kNumFeatures || mlp.outputSize() < 2) {
+                std::cerr << "Unexpected MLP shape " << mlp.inputSize() << " -> "
+                          << mlp.outputSize() << " in: " << modelPath << std::endl;
+                return;
+            }
+            backend = Backend::Native;
+            std::cout << "Native MLP (" << MlpController::kernelName()
+                      << (mlp.isQuantized() ? ", int8" : "")
+                      << ") loaded successfully from: " << modelPath << std::endl;
+        }
+        return;
+    }
+
+    if (requested == Backend::TorchScript) {
+#ifdef TC_WITH_TORCH
         try {
             model = torch::jit::load(modelPath);
             model.to(device);
-            modelLoaded = true;
+            model.eval();
+            backend = Backend::TorchScript;
 
             if (device == torch::kCUDA) {
                 std::cout << "CUDA is available. Using GPU." << std::endl;
@@ -28,84 +78,280 @@ TractionControl::TractionControl(double desiredSlip_, const std::string& modelPa
         } catch (const c10::Error& e) {
             std::cerr << "Error loading model: " << e.what() << std::endl;
         }
+#else
+        std::cerr << "Built without libtorch, cannot load TorchScript model: " << modelPath
+                  << " (export the weights to .bin for the native backend)" << std::endl;
+#endif
     }
 }
 
+void TractionControl::ensureCapacity(int64_t rows)
+{
+    if (rows <= inputCapacity) return;
+
+    nativeInput.assign(rows * kNumFeatures, 0.0f);
+    nativeOutput.assign(rows * std::max(2, mlp.outputSize()), 0.0f);
+
+#ifdef TC_WITH_TORCH
+    auto options = torch::TensorOptions().dtype(torch::kFloat);
+    hostInput = torch::zeros({rows, kNumFeatures},
+                             options.pinned_memory(device.is_cuda()));
+    deviceInput = device.is_cuda()
+                      ? torch::zeros({rows, kNumFeatures}, options.device(device))
+                      : hostInput;
+#endif
+    inputCapacity = rows;
+}
+
 void TractionControl::update(Vehicle& vehicle, double dt)
 {
-    const auto& wheels = vehicle.getWheels();
-    int n = static_cast<int>(wheels.size());
-
-    for (int i = 0; i < n; i++) {
-        double slip = vehicle.computeSlipRatio(i);
-        auto& w = wheels[i];
-
-        if (modelLoaded) {
-            try {
-                // Prepare input tensor
-                auto input = torch::tensor(
-                    {slip, w.angularVelocity, vehicle.getLinearSpeed(),
-                     w.brakeTorque, w.driveTorque, 0.0, 0.0, 0.0},
-                    torch::kFloat
-                ).to(device).unsqueeze(0);
-
-                std::cout << "Input Tensor (Wheel " << i << "): " << input << std::endl;
-
-                auto output = model.forward({input});
-                
-                if (output.isTuple()) {
-                    auto tupleOutput = output.toTuple();
-                    double predictedDriveTorque = tupleOutput->elements()[0].toTensor().item<double>();
-                    double predictedBrakeTorque = tupleOutput->elements()[1].toTensor().item<double>();
-
-                    // Apply predicted torques
-                    vehicle.setBrakeTorque(i, std::clamp(predictedBrakeTorque, 0.0, maxBrakeTorque));
-                    vehicle.setDriveTorque(i, std::clamp(predictedDriveTorque, 0.0, maxDriveTorque));
-                } else if (output.isTensor()) {
-                    auto tensorOutput = output.toTensor();
-                    if (tensorOutput.size(1) >= 2) { // Ensure at least two values in output tensor
-                        double predictedDriveTorque = tensorOutput[0][0].item<double>();
-                        double predictedBrakeTorque = tensorOutput[0][1].item<double>();
-
-                        // Apply predicted torques
-                        vehicle.setBrakeTorque(i, std::clamp(predictedBrakeTorque, 0.0, maxBrakeTorque));
-                        vehicle.setDriveTorque(i, std::clamp(predictedDriveTorque, 0.0, maxDriveTorque));
+    Vehicle* single = &vehicle;
+    updateVehicles(&single, 1, dt);
+}
+
+void TractionControl::updateBatch(const std::vector<Vehicle*>& vehicles, double dt)
+{
+    updateVehicles(vehicles.data(), vehicles.size(), dt);
+}
+
+void TractionControl::updateVehicles(Vehicle* const* vehicles, size_t count, double dt)
+{
+    if (backend == Backend::RuleBased) {
+        // Fallback: Default behavior
+        for (size_t v = 0; v < count; v++) {
+            int n = static_cast<int>(vehicles[v]->getWheels().size());
+            for (int i = 0; i < n; i++) {
+                ruleBasedUpdate(*vehicles[v], i, dt);
+            }
+        }
+        return;
+    }
+
+    int64_t rows = 0;
+    for (size_t v = 0; v < count; v++) {
+        rows += static_cast<int64_t>(vehicles[v]->getWheels().size());
+    }
+    if (rows == 0) return;
+    ensureCapacity(rows);
+
+    if (cache) {
+        updateCached(vehicles, count, rows, dt);
+        return;
+    }
+
+    if (backend == Backend::Native) {
+        packInputs(vehicles, count, nativeInput.data());
+        mlp.forward(nativeInput.data(), nativeOutput.data(), static_cast<int>(rows));
+        applyTorques(vehicles, count, nativeOutput.data(), mlp.outputSize());
+        return;
+    }
+
+#ifdef TC_WITH_TORCH
+    // Pack straight into the preallocated host buffer
+    packInputs(vehicles, count, hostInput.data_ptr<float>());
+    if (runTorch(rows, nativeOutput.data())) {
+        applyTorques(vehicles, count, nativeOutput.data(), 2);
+        return;
+    }
+
+    // Same fallback as a failed miss batch in updateCached
+    for (size_t v = 0; v < count; v++) {
+        int n = static_cast<int>(vehicles[v]->getWheels().size());
+        for (int i = 0; i < n; i++) {
+            ruleBasedUpdate(*vehicles[v], i, dt);
+        }
+    }
+#endif
+}
+
+void TractionControl::enableCache(const InferenceCacheConfig& config)
+{
+    cache = std::make_unique<InferenceCache>(config);
+}
+
+void TractionControl::updateCached(Vehicle* const* vehicles, size_t count, int64_t rows, double dt)
+{
+    const int outputs = InferenceCache::kOutputs;
+    packInputs(vehicles, count, nativeInput.data());
+
+    // Answer what the cache can and collect the rest for one model call
+    missKeys.clear();
+    missRows.clear();
+    missInput.clear();
+    for (int64_t r = 0; r < rows; r++) {
+        float* in = &nativeInput[r * kNumFeatures];
+        InferenceCache::Key key = cache->quantize(in);
+        if (!cache->lookup(key, &nativeOutput[r * outputs])) {
+            missKeys.push_back(key);
+            missRows.push_back(r);
+            missInput.insert(missInput.end(), in, in + kNumFeatures);
+        }
+    }
+
+    if (!missRows.empty()) {
+        int64_t misses = static_cast<int64_t>(missRows.size());
+        missOutput.resize(misses * std::max(2, mlp.outputSize()));
+        int64_t stride = 0;
+        if (!runModel(missInput.data(), misses, missOutput.data(), stride)) {
+            // Still apply what the cache answered; only the misses fall back
+            // to the rule-based update (missRows is ascending)
+            size_t m = 0;
+            int64_t r = 0;
+            for (size_t v = 0; v < count; v++) {
+                Vehicle& vehicle = *vehicles[v];
+                int n = static_cast<int>(vehicle.getWheels().size());
+                for (int i = 0; i < n; i++, r++) {
+                    if (m < missRows.size() && missRows[m] == r) {
+                        ruleBasedUpdate(vehicle, i, dt);
+                        m++;
                     } else {
-                        std::cerr << "Unexpected tensor shape in model output." << std::endl;
+                        const float* out = &nativeOutput[r * outputs];
+                        vehicle.setBrakeTorque(i, std::clamp<double>(out[1], 0.0, maxBrakeTorque));
+                        vehicle.setDriveTorque(i, std::clamp<double>(out[0], 0.0, maxDriveTorque));
                     }
-                } else {
-                    std::cerr << "Unexpected model output type." << std::endl;
                 }
-            } catch (const c10::Error& e) {
-                std::cerr << "Model inference error: " << e.what() << std::endl;
             }
-        } else {
-            // Fallback: Default behavior
-            double slipError = slip - desiredSlip;
+            return;
+        }
 
-            double currentBrake = w.brakeTorque;
-            double currentDrive = w.driveTorque;
+        for (int64_t m = 0; m < misses; m++) {
+            const float* out = &missOutput[m * stride];
+            cache->insert(missKeys[m], out);
+            std::copy_n(out, outputs, &nativeOutput[missRows[m] * outputs]);
+        }
+    }
 
-            if (slipError > 0.0) {
-                double inc = brakeRampRate * slipError * dt;  
-                double dec = driveRampRate * slipError * dt;  
+    applyTorques(vehicles, count, nativeOutput.data(), outputs);
+}
 
-                double newBrake = std::min(maxBrakeTorque, currentBrake + inc);
-                double newDrive = std::max(0.0, currentDrive - dec);
+bool TractionControl::runModel(const float* in, int64_t rows, float* out, int64_t& stride)
+{
+    if (backend == Backend::Native) {
+        mlp.forward(in, out, static_cast<int>(rows));
+        stride = mlp.outputSize();
+        return true;
+    }
 
-                vehicle.setBrakeTorque(i, newBrake);
-                vehicle.setDriveTorque(i, newDrive);
-            } else {
-                double slipMag = -slipError;
-                double dec = brakeRampRate * slipMag * dt;
-                double inc = driveRampRate * slipMag * dt;
+#ifdef TC_WITH_TORCH
+    std::copy_n(in, rows * kNumFeatures, hostInput.data_ptr<float>());
+    stride = 2;
+    return runTorch(rows, out);
+#else
+    return false;
+#endif
+}
 
-                double newBrake = std::max(0.0, currentBrake - dec);
-                double newDrive = std::min(maxDriveTorque, currentDrive + inc);
+void TractionControl::packInputs(Vehicle* const* vehicles, size_t count, float* in) const
+{
+    // One row per wheel. The last three features are not computed by the
+    // simulation yet.
+    for (size_t v = 0; v < count; v++) {
+        const Vehicle& vehicle = *vehicles[v];
+        const auto& wheels = vehicle.getWheels();
+        for (int i = 0; i < static_cast<int>(wheels.size()); i++) {
+            in[0] = static_cast<float>(vehicle.computeSlipRatio(i));
+            in[1] = static_cast<float>(wheels[i].angularVelocity);
+            in[2] = static_cast<float>(vehicle.getLinearSpeed());
+            in[3] = static_cast<float>(wheels[i].brakeTorque);
+            in[4] = static_cast<float>(wheels[i].driveTorque);
+            in[5] = 0.0f;
+            in[6] = 0.0f;
+            in[7] = 0.0f;
+            in += kNumFeatures;
+        }
+    }
+}
 
-                vehicle.setBrakeTorque(i, newBrake);
-                vehicle.setDriveTorque(i, newDrive);
+void TractionControl::applyTorques(Vehicle* const* vehicles, size_t count, const float* out, int64_t stride) const
+{
+    // Model output per wheel: [drive, brake]
+    for (size_t v = 0; v < count; v++) {
+        Vehicle& vehicle = *vehicles[v];
+        int n = static_cast<int>(vehicle.getWheels().size());
+        for (int i = 0; i < n; i++) {
+            double predictedDriveTorque = out[0];
+            double predictedBrakeTorque = out[1];
+
+            // Apply predicted torques
+            vehicle.setBrakeTorque(i, std::clamp(predictedBrakeTorque, 0.0, maxBrakeTorque));
+            vehicle.setDriveTorque(i, std::clamp(predictedDriveTorque, 0.0, maxDriveTorque));
+            out += stride;
+        }
+    }
+}
+
+#ifdef TC_WITH_TORCH
+bool TractionControl::runTorch(int64_t rows, float* out)
+{
+    // Inputs are in the first `rows` rows of hostInput; out gets rows x [drive, brake]
+    try {
+        c10::InferenceMode guard;
+
+        torch::Tensor input = deviceInput.narrow(0, 0, rows);
+        if (device.is_cuda()) {
+            input.copy_(hostInput.narrow(0, 0, rows), /*non_blocking=*/true);
+        }
+
+        auto output = model.forward({input});
+
+        // Bring the whole batch back in one transfer: column 0 = drive, 1 = brake
+        torch::Tensor torques;
+        if (output.isTuple()) {
+            const auto& elements = output.toTuple()->elements();
+            if (elements.size() < 2) {
+                std::cerr << "Unexpected tuple size in model output." << std::endl;
+                return false;
+            }
+            torques = torch::stack({elements[0].toTensor().reshape({rows}),
+                                    elements[1].toTensor().reshape({rows})}, 1);
+        } else if (output.isTensor()) {
+            torques = output.toTensor();
+            if (torques.dim() != 2 || torques.size(0) != rows || torques.size(1) < 2) {
+                std::cerr << "Unexpected tensor shape in model output." << std::endl;
+                return false;
             }
+        } else {
+            std::cerr << "Unexpected model output type." << std::endl;
+            return false;
         }
+        torques = torques.narrow(1, 0, 2).to(torch::kCPU, torch::kFloat).contiguous();
+        std::copy_n(torques.data_ptr<float>(), rows * 2, out);
+        return true;
+    } catch (const c10::Error& e) {
+        std::cerr << "Model inference error: " << e.what() << std::endl;
+        return false;
+    }
+}
+#endif
+
+void TractionControl::ruleBasedUpdate(Vehicle& vehicle, int i, double dt)
+{
+    double slip = vehicle.computeSlipRatio(i);
+    const auto& w = vehicle.getWheels()[i];
+
+    double slipError = slip - desiredSlip;
+
+    double currentBrake = w.brakeTorque;
+    double currentDrive = w.driveTorque;
+
+    if (slipError > 0.0) {
+        double inc = brakeRampRate * slipError * dt;
+        double dec = driveRampRate * slipError * dt;
+
+        double newBrake = std::min(maxBrakeTorque, currentBrake + inc);
+        double newDrive = std::max(0.0, currentDrive - dec);
+
+        vehicle.setBrakeTorque(i, newBrake);
+        vehicle.setDriveTorque(i, newDrive);
+    } else {
+        double slipMag = -slipError;
+        double dec = brakeRampRate * slipMag * dt;
+        double inc = driveRampRate * slipMag * dt;
+
+        double newBrake = std::max(0.0, currentBrake - dec);
+        double newDrive = std::min(maxDriveTorque, currentDrive + inc);
+
+        vehicle.setBrakeTorque(i, newBrake);
+        vehicle.setDriveTorque(i, newDrive);
     }
-}
\ No newline at end of file
+}
@@ -3,8 +3,15 @@
 #include <cmath>
 
 Vehicle::Vehicle(double initialSpeed, int numWheels)
-    : linearSpeed(initialSpeed)
+    : wheelRadius(0.3),   // 30 cm
+      mass(1200),         // 1200 kg
+      wheelInertia(1.0),  // 1 kg·m^2 (rough guess)
+      muPeak(1.0),        // friction coefficient for good tires on dry asphalt
+      slipOpt(0.1),       // ~10% slip is often near peak traction
+      linearSpeed(initialSpeed)
 {
+    // Parameters are initialized first so the wheels start rolling at the
+    // vehicle speed instead of reading an uninitialized wheelRadius.
     wheels.resize(numWheels);
     for (auto& w : wheels) {
 
@@ -16,12 +23,6 @@ Vehicle::Vehicle(double initialSpeed, int numWheels)
         w.driveTorque     = 0.0;
         w.rotationAngle   = 0.0;
     }
-
-    wheelRadius  = 0.3;   // 30 cm
-    mass         = 1200;  // 1200 kg
-    wheelInertia = 1.0;   // 1 kg·m^2 (rough guess)
-    muPeak       = 1.0;   // friction coefficient for good tires on dry asphalt
-    slipOpt      = 0.1;   // ~10% slip is often near peak traction
 }
 
 void Vehicle::update(double dt)
@@ -1,5 +1,8 @@
 #include <SDL.h>
+#include <cstdlib>
+#include <iostream>
 #include <memory>
+#include <string>
 #include "Vehicle.h"
 #include "TractionControl.h"
 #include "Visualizer.h"
@@ -7,12 +10,36 @@
 
 int main(int argc, char* argv[])
 {
+    // A ".bin" path selects the native MLP backend, anything else TorchScript
+    std::string modelPath = "mlp_model_traced.pt";
+    bool useCache = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--cache") {
+            useCache = true;
+        } else if (arg.rfind("--", 0) != 0) {
+            modelPath = arg;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [MODEL] [--cache]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
     auto vehicle = std::make_shared<Vehicle>(5.0, 4);
-    auto tc = std::make_shared<TractionControl>(0.1, "mlp_model_traced.pt");
+    auto tc = std::make_shared<TractionControl>(0.1, modelPath);
+    if (useCache) {
+        tc->enableCache();
+    }
     auto vis = std::make_shared<Visualizer>();
 
     Simulation sim(vehicle, tc, vis);
     sim.run();
 
+    if (const InferenceCache* cache = tc->getCache()) {
+        std::cout << "Inference cache: " << cache->hits() << " hits, " << cache->misses()
+                  << " misses (" << 100.0 * cache->hitRate() << "% hit rate)" << std::endl;
+    }
+
     return 0;
 }
\ No newline at end of file
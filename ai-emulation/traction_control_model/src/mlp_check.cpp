@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "MlpController.h"
+
+// Accuracy gate for exported weights, e.g. an int8 export against its
+// float32 original: replays a dataset CSV (data_generator columns) through
+// both models with the same inputs as TractionControl and exits with 1 if
+// the mean torque difference exceeds --max-error.
+
+namespace {
+
+const int    kNumFeatures    = 8;
+const double kMaxBrakeTorque = 200.0;  // clamps of TractionControl::applyTorques
+const double kMaxDriveTorque = 150.0;
+
+struct Dataset {
+    std::vector<float> features;  // rows x kNumFeatures
+    std::vector<float> targets;   // rows x 2: drive, brake
+    int rows = 0;
+};
+
+bool loadDataset(const std::string& path, Dataset& data)
+{
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Error opening dataset: " << path << std::endl;
+        return false;
+    }
+
+    // Same order as TractionControl::packInputs; the last three stay zero
+    const char* const inputs[] = {"slip_ratio", "angular_velocity", "linear_speed",
+                                  "current_brake_torque", "current_drive_torque",
+                                  "desired_drive_torque", "desired_brake_torque"};
+    std::string line;
+    std::getline(file, line);
+    std::vector<std::string> header;
+    std::istringstream names(line);
+    for (std::string name; std::getline(names, name, ',');) {
+        header.push_back(name);
+    }
+
+    int columns[7];
+    for (int c = 0; c < 7; c++) {
+        auto it = std::find(header.begin(), header.end(), inputs[c]);
+        if (it == header.end()) {
+            std::cerr << "Dataset has no column " << inputs[c] << ": " << path << std::endl;
+            return false;
+        }
+        columns[c] = (int)(it - header.begin());
+    }
+
+    std::vector<double> values;
+    while (std::getline(file, line)) {
+        values.clear();
+        std::istringstream fields(line);
+        for (std::string field; std::getline(fields, field, ',');) {
+            values.push_back(std::atof(field.c_str()));
+        }
+        if (values.size() < header.size()) continue;
+
+        for (int c = 0; c < 5; c++) {
+            data.features.push_back((float)values[columns[c]]);
+        }
+        data.features.insert(data.features.end(), kNumFeatures - 5, 0.0f);
+        data.targets.push_back((float)values[columns[5]]);
+        data.targets.push_back((float)values[columns[6]]);
+        data.rows++;
+    }
+
+    if (data.rows == 0) {
+        std::cerr << "Dataset has no rows: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Clamped torques per row (drive, brake) and the forward time per row
+bool evaluate(const std::string& path, const Dataset& data, std::vector<double>& torques,
+              double& microsPerRow, std::size_t& weightBytes)
+{
+    MlpController mlp;
+    if (!mlp.load(path)) return false;
+    if (mlp.inputSize() != kNumFeatures || mlp.outputSize() < 2) {
+        std::cerr << "Unexpected MLP shape " << mlp.inputSize() << " -> "
+                  << mlp.outputSize() << " in: " << path << std::endl;
+        return false;
+    }
+
+    std::vector<float> output((size_t)data.rows * mlp.outputSize());
+    mlp.forward(data.features.data(), output.data(), data.rows);
+
+    // One control step evaluates 4 wheels; time that, repeated over the dataset
+    using clock = std::chrono::steady_clock;
+    const int repeats = 20;
+    auto start = clock::now();
+    for (int r = 0; r < repeats; r++) {
+        for (int row = 0; row + 4 <= data.rows; row += 4) {
+            mlp.forward(&data.features[(size_t)row * kNumFeatures], &output[(size_t)row * mlp.outputSize()], 4);
+        }
+    }
+    double seconds = std::chrono::duration<double>(clock::now() - start).count();
+    microsPerRow = seconds * 1e6 / ((double)repeats * (data.rows / 4 * 4));
+    weightBytes  = mlp.weightBytes();
+
+    torques.resize((size_t)data.rows * 2);
+    for (int row = 0; row < data.rows; row++) {
+        const float* out = &output[(size_t)row * mlp.outputSize()];
+        torques[2 * row]     = std::clamp((double)out[0], 0.0, kMaxDriveTorque);
+        torques[2 * row + 1] = std::clamp((double)out[1], 0.0, kMaxBrakeTorque);
+    }
+    return true;
+}
+
+double meanAbsError(const std::vector<double>& a, const std::vector<float>& b)
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < a.size(); i++) {
+        sum += std::fabs(a[i] - b[i]);
+    }
+    return sum / a.size();
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::string> paths;
+    double maxError = 1.0;  // N·m
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--max-error" && i + 1 < argc) {
+            maxError = std::atof(argv[++i]);
+        } else if (arg.rfind("--", 0) != 0) {
+            paths.push_back(arg);
+        } else {
+            paths.clear();
+            break;
+        }
+    }
+    if (paths.size() != 3) {
+        std::cerr << "Usage: " << argv[0] << " REFERENCE.bin CANDIDATE.bin DATASET.csv [--max-error NM]"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Dataset data;
+    if (!loadDataset(paths[2], data)) return EXIT_FAILURE;
+
+    std::vector<double> reference, candidate;
+    double refMicros = 0.0, candMicros = 0.0;
+    std::size_t refBytes = 0, candBytes = 0;
+    if (!evaluate(paths[0], data, reference, refMicros, refBytes) ||
+        !evaluate(paths[1], data, candidate, candMicros, candBytes)) {
+        return EXIT_FAILURE;
+    }
+
+    double meanDiff = 0.0, maxDiff = 0.0;
+    for (size_t i = 0; i < reference.size(); i++) {
+        double diff = std::fabs(candidate[i] - reference[i]);
+        meanDiff += diff;
+        maxDiff = std::max(maxDiff, diff);
+    }
+    meanDiff /= reference.size();
+
+    std::cout << "Rows: " << data.rows << " | kernel: " << MlpController::kernelName() << std::endl;
+    std::cout << "Reference: " << refBytes / 1024.0 << " KiB, " << refMicros << " us/row"
+              << ", mean |torque - dataset| " << meanAbsError(reference, data.targets) << " N·m" << std::endl;
+    std::cout << "Candidate: " << candBytes / 1024.0 << " KiB, " << candMicros << " us/row"
+              << ", mean |torque - dataset| " << meanAbsError(candidate, data.targets) << " N·m" << std::endl;
+    std::cout << "Candidate vs reference: mean " << meanDiff << " N·m, max " << maxDiff << " N·m" << std::endl;
+
+    if (meanDiff > maxError) {
+        std::cerr << "FAIL: mean torque difference " << meanDiff << " N·m exceeds " << maxError << " N·m"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "OK (limit " << maxError << " N·m)" << std::endl;
+    return 0;
+}
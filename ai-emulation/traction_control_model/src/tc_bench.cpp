@@ -0,0 +1,155 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Vehicle.h"
+#include "TractionControl.h"
+
+// Controller benchmarks for every backend, per wheel count.
+//
+// JSON for regression tracking (model loading logs to stdout, so write the
+// report to a file):
+//   ./tc_bench --benchmark_out=bench.json --benchmark_out_format=json
+//
+// The TorchScript benchmark runs on the CPU unless CUDA is available (the
+// controller picks the device); set CUDA_VISIBLE_DEVICES= to force the CPU.
+
+#ifndef TC_MODEL_DIR
+#define TC_MODEL_DIR "."
+#endif
+
+namespace {
+
+const double kDt = 0.01;
+
+void runController(benchmark::State& state, const std::string& modelPath,
+                   TractionControl::Backend backend)
+{
+    int numWheels = static_cast<int>(state.range(0));
+    Vehicle vehicle(20.0, numWheels);
+    vehicle.update(kDt);
+
+    TractionControl tc(0.1, modelPath, backend);
+    if (tc.getBackend() != backend) {
+        state.SkipWithError(("cannot load " + modelPath).c_str());
+        return;
+    }
+
+    for (auto _ : state) {
+        tc.update(vehicle, kDt);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * numWheels);
+    state.counters["wheels"] = numWheels;
+}
+
+// Many vehicles evaluated with one forward pass through updateBatch
+void runControllerBatch(benchmark::State& state, const std::string& modelPath,
+                        TractionControl::Backend backend)
+{
+    int numVehicles = static_cast<int>(state.range(0));
+    std::vector<std::unique_ptr<Vehicle>> fleet;
+    std::vector<Vehicle*> vehicles;
+    for (int v = 0; v < numVehicles; v++) {
+        fleet.push_back(std::make_unique<Vehicle>(5.0 + v % 20, 4));
+        vehicles.push_back(fleet.back().get());
+    }
+
+    TractionControl tc(0.1, modelPath, backend);
+    if (tc.getBackend() != backend) {
+        state.SkipWithError(("cannot load " + modelPath).c_str());
+        return;
+    }
+
+    for (auto _ : state) {
+        tc.updateBatch(vehicles, kDt);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * numVehicles * 4);
+}
+
+} // namespace
+
+static void BM_RuleBasedControl(benchmark::State& state)
+{
+    runController(state, "", TractionControl::Backend::RuleBased);
+}
+BENCHMARK(BM_RuleBasedControl)->RangeMultiplier(2)->Range(2, 64);
+
+static void BM_NativeControl(benchmark::State& state)
+{
+    runController(state, TC_MODEL_DIR "/mlp_model_traced.bin", TractionControl::Backend::Native);
+    state.SetLabel(MlpController::kernelName());
+}
+BENCHMARK(BM_NativeControl)->RangeMultiplier(2)->Range(2, 64);
+
+static void BM_NativeControlBatch(benchmark::State& state)
+{
+    runControllerBatch(state, TC_MODEL_DIR "/mlp_model_traced.bin", TractionControl::Backend::Native);
+    state.SetLabel(MlpController::kernelName());
+}
+BENCHMARK(BM_NativeControlBatch)->RangeMultiplier(4)->Range(1, 256);
+
+// Same model exported with export_weights.py --int8
+static void BM_NativeInt8Control(benchmark::State& state)
+{
+    runController(state, TC_MODEL_DIR "/mlp_model_traced_int8.bin", TractionControl::Backend::Native);
+    state.SetLabel(std::string(MlpController::kernelName()) + " int8");
+}
+BENCHMARK(BM_NativeInt8Control)->RangeMultiplier(2)->Range(2, 64);
+
+static void BM_NativeInt8ControlBatch(benchmark::State& state)
+{
+    runControllerBatch(state, TC_MODEL_DIR "/mlp_model_traced_int8.bin", TractionControl::Backend::Native);
+    state.SetLabel(std::string(MlpController::kernelName()) + " int8");
+}
+BENCHMARK(BM_NativeInt8ControlBatch)->RangeMultiplier(4)->Range(1, 256);
+
+// Closed loop (control + physics) from a standing start, without (Arg 0) and
+// with (Arg 1) the inference cache; the vehicle restarts every 1000 steps
+static void BM_NativeClosedLoop(benchmark::State& state)
+{
+    const std::string modelPath = TC_MODEL_DIR "/mlp_model_traced.bin";
+    TractionControl tc(0.1, modelPath, TractionControl::Backend::Native);
+    if (tc.getBackend() != TractionControl::Backend::Native) {
+        state.SkipWithError(("cannot load " + modelPath).c_str());
+        return;
+    }
+    if (state.range(0) == 1) {
+        tc.enableCache();
+    }
+
+    Vehicle vehicle(5.0, 4);
+    int step = 0;
+    for (auto _ : state) {
+        if (++step == 1000) {
+            vehicle = Vehicle(5.0, 4);
+            step = 0;
+        }
+        tc.update(vehicle, kDt);
+        vehicle.update(kDt);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * 4);
+    if (const InferenceCache* cache = tc.getCache()) {
+        state.counters["hit_rate"] = cache->hitRate();
+    }
+    state.SetLabel(state.range(0) == 1 ? "cached" : "uncached");
+}
+BENCHMARK(BM_NativeClosedLoop)->DenseRange(0, 1);
+
+#ifdef TC_WITH_TORCH
+static void BM_TorchScriptControl(benchmark::State& state)
+{
+    runController(state, TC_MODEL_DIR "/mlp_model_traced.pt", TractionControl::Backend::TorchScript);
+}
+BENCHMARK(BM_TorchScriptControl)->RangeMultiplier(2)->Range(2, 64);
+
+static void BM_TorchScriptControlBatch(benchmark::State& state)
+{
+    runControllerBatch(state, TC_MODEL_DIR "/mlp_model_traced.pt", TractionControl::Backend::TorchScript);
+}
+BENCHMARK(BM_TorchScriptControlBatch)->RangeMultiplier(4)->Range(1, 256);
+#endif
+
+BENCHMARK_MAIN();
@@ -1,3 +1,4 @@
+import sys
 import torch
 import pandas as pd
 import torch.optim as optim
@@ -6,12 +7,18 @@ from sklearn.model_selection import train_test_split
 from sklearn.preprocessing import MinMaxScaler
 from torch.utils.data import DataLoader, TensorDataset
 from modules.MLPClass import MLPModel
+from modules.dataset_io import ColumnarDataset, ChunkStreamDataset, OnlineSimulationDataset
 from modules.training_tools import get_device, train_model_with_early_stopping, set_seed
 
 SEED = 42
 
-file_path = "./datasets/simulation_data_cleaned.csv"
-df = pd.read_csv(file_path)
+# CSV datasets are loaded into memory; .bin datasets written by
+# data_generator --format bin are memory-mapped and streamed chunk by chunk.
+# "--online [ROWS]" simulates ROWS fresh rows per epoch in-process through the
+# tc_sim module instead (build emulation with -DBUILD_PYTHON_MODULE=ON and add
+# the build directory to PYTHONPATH).
+file_path = sys.argv[1] if len(sys.argv) > 1 else "./datasets/simulation_data_cleaned.csv"
+ONLINE_ROWS = int(sys.argv[2]) if file_path == "--online" and len(sys.argv) > 2 else 1_000_000
 
 features = ['slip_ratio', 'angular_velocity', 'linear_speed', 
             'current_brake_torque', 'current_drive_torque', 
@@ -20,28 +27,69 @@ targets = ['desired_drive_torque', 'desired_brake_torque']
 
 set_seed(SEED)
 
-X = df[features].values
-y = df[targets].values
+if file_path == "--online":
+    # Fixed validation rows (which also fit the scalers), fresh training rows every epoch
+    val_dataset = OnlineSimulationDataset(ONLINE_ROWS // 4, features, targets, batch_size=64,
+                                          shuffle=False, resample=False, seed=SEED)
+    train_dataset = OnlineSimulationDataset(ONLINE_ROWS, features, targets, batch_size=64,
+                                            shuffle=True, seed=SEED + 1,
+                                            scalers=(val_dataset.feature_scaler, val_dataset.target_scaler))
+    target_scaler = train_dataset.target_scaler
 
-scaler = MinMaxScaler()
-X = scaler.fit_transform(X)
+    train_loader = DataLoader(train_dataset, batch_size=None)
+    val_loader = DataLoader(val_dataset, batch_size=None)
+elif file_path.endswith(".bin"):
+    dataset = ColumnarDataset(file_path)
 
-target_scaler = MinMaxScaler()
-y = target_scaler.fit_transform(y)
+    if dataset.num_rows < 2:
+        sys.exit(f"{file_path} needs at least 2 rows to split into training and validation")
 
-X_train, X_val, y_train, y_val = train_test_split(X, y, test_size=0.2, random_state=42)
+    if dataset.num_chunks > 1:
+        # Hold out the last 20% of the chunks for validation
+        num_val_chunks = max(1, dataset.num_chunks // 5)
+        train_chunks = range(dataset.num_chunks - num_val_chunks)
+        val_chunks = range(dataset.num_chunks - num_val_chunks, dataset.num_chunks)
+        train_rows = val_rows = None
+    else:
+        # A single chunk: hold out its last 20% of the rows instead
+        split = dataset.num_rows - max(1, dataset.num_rows // 5)
+        train_chunks = val_chunks = [0]
+        train_rows, val_rows = (0, split), (split, dataset.num_rows)
 
-device = get_device()
-X_train = torch.tensor(X_train, dtype=torch.float32)
-y_train = torch.tensor(y_train, dtype=torch.float32)
-X_val = torch.tensor(X_val, dtype=torch.float32)
-y_val = torch.tensor(y_val, dtype=torch.float32)
+    train_dataset = ChunkStreamDataset(dataset, features, targets, train_chunks, batch_size=64, shuffle=True, seed=SEED,
+                                       row_range=train_rows)
+    val_dataset = ChunkStreamDataset(dataset, features, targets, val_chunks, batch_size=64, shuffle=False,
+                                     row_range=val_rows)
+    target_scaler = train_dataset.target_scaler
+
+    train_loader = DataLoader(train_dataset, batch_size=None)
+    val_loader = DataLoader(val_dataset, batch_size=None)
+else:
+    df = pd.read_csv(file_path)
+
+    X = df[features].values
+    y = df[targets].values
+
+    scaler = MinMaxScaler()
+    X = scaler.fit_transform(X)
+
+    target_scaler = MinMaxScaler()
+    y = target_scaler.fit_transform(y)
 
-train_dataset = TensorDataset(X_train, y_train)
-val_dataset = TensorDataset(X_val, y_val)
+    X_train, X_val, y_train, y_val = train_test_split(X, y, test_size=0.2, random_state=42)
 
-train_loader = DataLoader(train_dataset, batch_size=64, shuffle=True)
-val_loader = DataLoader(val_dataset, batch_size=64, shuffle=False)
+    X_train = torch.tensor(X_train, dtype=torch.float32)
+    y_train = torch.tensor(y_train, dtype=torch.float32)
+    X_val = torch.tensor(X_val, dtype=torch.float32)
+    y_val = torch.tensor(y_val, dtype=torch.float32)
+
+    train_dataset = TensorDataset(X_train, y_train)
+    val_dataset = TensorDataset(X_val, y_val)
+
+    train_loader = DataLoader(train_dataset, batch_size=64, shuffle=True)
+    val_loader = DataLoader(val_dataset, batch_size=64, shuffle=False)
+
+device = get_device()
 
 input_size = len(features)
 hidden_size = 128
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "Vehicle.h"
+#include "TractionControl.h"
+#include "Snapshot.h"
+#include "SurfaceProfile.h"
+
+// One independent, headless rollout of a Vehicle + TractionControl pair.
+struct Scenario {
+    double friction      = 1.0;   // road muPeak
+    double initialSpeed  = 10.0;  // m/s
+    double desiredSlip   = 0.1;   // traction control target
+    int    steps         = 1000;  // number of physics steps
+    int    numWheels     = 4;
+    double frictionNoise = 0.0;   // std-dev of per-step friction jitter (0 = uniform road)
+    TractionGains gains;          // controller limits and ramp rates
+    // Friction along the track, scaled by `friction` (nullptr = uniform road).
+    // Distances count from the start of the rollout.
+    std::shared_ptr<const SurfaceProfile> surface;
+    // Wheel integrator (see Vehicle::setIntegrator); anything but plain Euler
+    // runs on the dynamic Vehicle
+    Vehicle::Integrator integrator = Vehicle::Integrator::Euler;
+    double integratorTolerance = 0.0;  // rad/s, 0 = fixed step
+};
+
+struct ScenarioResult {
+    double finalSpeed;        // m/s at the end of the rollout
+    double distance;          // meters travelled
+    double meanSlipError;     // mean |slip - desiredSlip| over all wheels and steps
+    double maxAbsSlip;        // worst |slip| seen on any wheel
+    double stoppingDistance;  // meters until the speed fell below 10% of the initial speed
+                              // (all of `distance` if it never did)
+};
+
+struct BatchStats {
+    std::size_t scenarios  = 0;
+    int         threads    = 0;
+    double      seconds    = 0.0;
+    double      scenariosPerSecond = 0.0;
+};
+
+// Runs many scenarios in parallel without any rendering (no SDL dependency).
+// Every scenario draws from its own RNG stream keyed by (seed, scenario index),
+// so results are identical regardless of thread count or scheduling.
+class BatchSimulation {
+public:
+    // numThreads <= 0 uses std::thread::hardware_concurrency().
+    explicit BatchSimulation(int numThreads = 0, std::uint64_t seed = 0, double physicsDt = 0.01);
+
+    std::vector<ScenarioResult> run(const std::vector<Scenario>& scenarios);
+
+    // Branches: scenario i continues from starts[i] instead of a fresh
+    // vehicle. Speed, wheels, desired slip and gains come from the snapshot;
+    // the scenario supplies the road (friction, noise) and the step count.
+    // Returns an empty vector if the sizes differ.
+    std::vector<ScenarioResult> run(const std::vector<Scenario>& scenarios, const SnapshotArena& starts);
+
+    // Tire curve used by every rollout; nullptr (default) is the exponential model.
+    void setTireModel(std::shared_ptr<const FrictionTable> table) { tireTable = std::move(table); }
+
+    const BatchStats& lastStats() const { return stats; }
+    int getNumThreads() const { return numThreads; }
+
+    // Cartesian product of the given parameter values.
+    static std::vector<Scenario> makeGrid(const std::vector<double>& frictions,
+                                          const std::vector<double>& speeds,
+                                          const std::vector<double>& desiredSlips,
+                                          int steps, int numWheels = 4);
+
+    // Single rollout; exposed so callers can reproduce one entry of a batch.
+    static ScenarioResult runScenario(const Scenario& scenario, std::uint64_t streamSeed, double dt,
+                                      std::shared_ptr<const FrictionTable> tireTable = nullptr,
+                                      const SimulationSnapshot* start = nullptr);
+
+    // Seed of the RNG stream used for scenario `index`.
+    std::uint64_t streamSeed(std::size_t index) const;
+
+private:
+    int numThreads;
+    std::uint64_t seed;
+    double physicsDt;
+    std::shared_ptr<const FrictionTable> tireTable;
+    BatchStats stats;
+
+    std::vector<ScenarioResult> runAll(const std::vector<Scenario>& scenarios, const SnapshotArena* starts);
+};
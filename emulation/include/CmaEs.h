@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Covariance matrix adaptation evolution strategy (Hansen's (mu/mu_w, lambda)
+// CMA-ES) minimizing a black-box function of a few real parameters.
+//
+// Ask/tell interface so the caller decides how candidates are evaluated
+// (e.g. all of a generation in one parallel batch):
+//
+//     CmaEs es(start, 0.3, 0, seed);
+//     for (int g = 0; g < generations; g++) {
+//         auto xs = es.ask();
+//         es.tell(xs, evaluate(xs));
+//     }
+class CmaEs {
+public:
+    // population <= 0 uses the default 4 + 3 ln(n)
+    CmaEs(const std::vector<double>& mean, double sigma, int population = 0, std::uint64_t seed = 0);
+
+    // Samples one generation of `population` candidates
+    std::vector<std::vector<double>> ask();
+
+    // Updates the distribution from the candidates of the last ask() and
+    // their fitness (lower is better)
+    void tell(const std::vector<std::vector<double>>& candidates, const std::vector<double>& fitness);
+
+    const std::vector<double>& getMean() const { return mean; }
+    double getSigma() const { return sigma; }
+    int getPopulation() const { return lambda; }
+    int getGeneration() const { return generation; }
+
+private:
+    int n;
+    int lambda;
+    int mu;
+    std::vector<double> weights;
+    double muEff;
+
+    // Adaptation rates
+    double cc, cs, c1, cmu, damps, chiN;
+
+    std::vector<double> mean;
+    double sigma;
+    std::vector<double> pc, ps;                // evolution paths
+    std::vector<std::vector<double>> C;        // covariance
+    std::vector<std::vector<double>> B;        // eigenvectors of C (columns)
+    std::vector<double> D;                     // sqrt of the eigenvalues of C
+    int generation = 0;
+
+    std::mt19937_64 rng;
+    std::normal_distribution<double> normal;
+
+    void decompose();
+};
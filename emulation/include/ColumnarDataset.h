@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+
+// Columnar training-set format ("TCTR" version 2), written by BinaryTraceSink
+// and read here through mmap and by modules/dataset_io.py via numpy.memmap.
+// All values are little-endian.
+//
+//   offset 0   char[4]  magic "TCTR"
+//          4   uint32   version (2)
+//          8   uint32   numColumns
+//         12   uint32   chunkRows     rows per chunk
+//         16   uint64   numRows       valid rows (the last chunk is zero padded)
+//         24   uint64   dataOffset    start of the first chunk, 4096-aligned
+//         32   byte[32] reserved
+//         64   numColumns column descriptors of 48 bytes:
+//                char[32] name (NUL padded), float32 min, float32 max, byte[8] reserved
+//   dataOffset + k * numColumns * chunkRows * 4:
+//              chunk k, column-major: numColumns runs of chunkRows float32
+//
+// Every chunk has the same size, so the payload is a dense
+// float32[numChunks][numColumns][chunkRows] array. The min/max of every
+// column are stored in the header so training can scale inputs without a
+// pass over the data.
+namespace dataset {
+
+const char     kMagic[4]       = {'T', 'C', 'T', 'R'};
+const uint32_t kVersion        = 2;
+const std::size_t kHeaderBytes = 64;
+const std::size_t kColumnBytes = 48;
+const std::size_t kNameBytes   = 32;
+const std::size_t kAlignment   = 4096;
+
+struct ColumnInfo {
+    std::string name;
+    float min;
+    float max;
+};
+
+} // namespace dataset
+
+// Read-only, zero-copy view of a dataset file.
+class ColumnarDataset {
+public:
+    bool open(const std::string& path);
+    void close();
+
+    std::size_t getNumRows() const { return numRows; }
+    std::size_t getNumChunks() const { return numChunks; }
+    std::size_t getChunkRows() const { return chunkRows; }
+    int getNumColumns() const { return (int)columns.size(); }
+    const std::vector<dataset::ColumnInfo>& getColumns() const { return columns; }
+
+    // -1 if the column does not exist
+    int columnIndex(const std::string& name) const;
+
+    // Contiguous chunkRows values of one column inside one chunk
+    const float* chunkColumn(std::size_t chunk, int column) const
+    {
+        return data + (chunk * columns.size() + column) * chunkRows;
+    }
+
+    // Rows of `chunk` that hold data (chunkRows except for the last chunk)
+    std::size_t rowsInChunk(std::size_t chunk) const;
+
+    float value(std::size_t row, int column) const
+    {
+        return chunkColumn(row / chunkRows, column)[row % chunkRows];
+    }
+
+private:
+    MappedFile file;
+    const float* data = nullptr;
+    std::size_t numRows = 0;
+    std::size_t numChunks = 0;
+    std::size_t chunkRows = 0;
+    std::vector<dataset::ColumnInfo> columns;
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include "TraceWriter.h"
+
+// Runs randomized traction-control scenarios and pushes one record per wheel
+// and step to `writer` until numEntries rows were produced.
+// Returns the number of rows written.
+//
+// Scenario k draws its parameters from Philox stream (seed, k), and scenarios
+// are simulated in shards of consecutive scenarios on numThreads workers. The
+// shards reach the writer in scenario order, so the output depends only on
+// (seed, numEntries) and is bit-identical for any thread count.
+long long generateData(TraceWriter& writer, long long numEntries,
+                       std::uint64_t seed = 0, int numThreads = 1);
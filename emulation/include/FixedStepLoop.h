@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+struct StepStats {
+    uint64_t steps        = 0;    // steps executed
+    uint64_t overruns     = 0;    // steps that finished after their deadline
+    uint64_t droppedSteps = 0;    // steps skipped after falling too far behind
+    double   maxStepSeconds  = 0.0;  // longest single step
+    double   lastStepSeconds = 0.0;
+};
+
+// Calls a step function on a dedicated thread at a fixed rate.
+//
+// Every step has a deadline one period after the previous one and the thread
+// sleeps until it (sleep_until, so timing errors do not accumulate). A step
+// that ends past its deadline counts as an overrun; the following steps then
+// run back to back to catch up, but at most maxCatchUpSteps of them. Beyond
+// that the lost time is dropped instead of bunching up into ever longer
+// bursts (the "spiral of death").
+//
+// The time scale divides the wall-clock period: 10 runs 10 steps in the time
+// of one. A time scale <= 0, or one so large that the period rounds to zero
+// clock ticks, runs the steps back to back as fast as possible, without
+// deadlines.
+class FixedStepLoop {
+public:
+    explicit FixedStepLoop(double stepSeconds = 0.01, int maxCatchUpSteps = 5, double timeScale = 1.0);
+    ~FixedStepLoop();
+
+    FixedStepLoop(const FixedStepLoop&) = delete;
+    FixedStepLoop& operator=(const FixedStepLoop&) = delete;
+
+    // The loop ends by itself when step returns false
+    void start(std::function<bool()> step);
+    void stop();
+    void wait();  // until step returns false
+    bool isRunning() const { return worker.joinable(); }
+    bool isFinished() const { return finished.load(std::memory_order_acquire); }
+
+    double getStepSeconds() const { return stepSeconds; }
+    double getTimeScale() const { return timeScale; }
+
+    // Safe to call from any thread while the loop runs
+    StepStats getStats() const;
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    double stepSeconds;
+    int maxCatchUpSteps;
+    double timeScale;
+    clock::duration period{0};  // wall-clock time per step, 0 = unpaced
+    std::function<bool()> step;
+
+    std::atomic<bool> stopRequested{false};
+    std::atomic<bool> finished{false};
+    std::thread worker;
+
+    // Written by the loop thread only
+    std::atomic<uint64_t> steps{0};
+    std::atomic<uint64_t> overruns{0};
+    std::atomic<uint64_t> droppedSteps{0};
+    std::atomic<int64_t>  maxStepNanos{0};
+    std::atomic<int64_t>  lastStepNanos{0};
+
+    void run();
+    void runUnpaced();
+    bool timedStep();
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <algorithm>
+#include "FixedVehicle.h"
+#include "TractionControl.h"
+
+// TractionControl for a FixedVehicle<N>: same control law and gains with
+// the wheel loop unrolled.
+template <int N>
+class FixedTractionControl {
+public:
+    explicit FixedTractionControl(double desiredSlip = 0.1, const TractionGains& gains = TractionGains())
+        : desiredSlip(desiredSlip), gains(gains)
+    {}
+
+    void update(FixedVehicle<N>& vehicle, double dt)
+    {
+        FixedVehicle<N>::forEachWheel([&](int i) {
+            const auto& w = vehicle.getWheels()[i];
+            double slipError = vehicle.computeSlipRatio(i) - desiredSlip;
+
+            if (slipError > 0.0) {
+                // Too much slip => ramp up brake, ramp down drive
+                vehicle.setBrakeTorque(i, std::min(gains.maxBrakeTorque, w.brakeTorque + gains.brakeRampRate * slipError * dt));
+                vehicle.setDriveTorque(i, std::max(0.0, w.driveTorque - gains.driveRampRate * slipError * dt));
+            } else {
+                // slip <= desired => reduce brake, ramp up drive
+                double slipMag = -slipError;
+                vehicle.setBrakeTorque(i, std::max(0.0, w.brakeTorque - gains.brakeRampRate * slipMag * dt));
+                vehicle.setDriveTorque(i, std::min(gains.maxDriveTorque, w.driveTorque + gains.driveRampRate * slipMag * dt));
+            }
+        });
+    }
+
+private:
+    double desiredSlip;
+    TractionGains gains;
+};
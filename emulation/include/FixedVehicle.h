@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include "Vehicle.h"
+
+// Vehicle with the wheel count fixed at compile time.
+//
+// Same model and the same floating-point operations, in the same order, as
+// the dynamic Vehicle, so both produce identical results. The wheels live in
+// a std::array, the per-wheel loops are expanded at compile time, the
+// physical constants are constexpr, and the accessors take unchecked indices
+// (asserted in debug builds). Use Vehicle for wheel counts chosen at run time.
+template <int N>
+class FixedVehicle {
+    static_assert(N > 0, "a vehicle needs at least one wheel");
+
+public:
+    using Wheel = Vehicle::Wheel;
+
+    static constexpr int    kNumWheels      = N;
+    static constexpr double kWheelRadius    = 0.3;     // meters
+    static constexpr double kMass           = 1200.0;  // kg
+    static constexpr double kWheelInertia   = 1.0;     // kg·m^2
+    static constexpr double kFrictionShape  = Vehicle::kFrictionShape;
+    static constexpr double kNormalForce    = (kMass * 9.81) / N;  // equal weight distribution
+
+    explicit FixedVehicle(double initialSpeed)
+        : linearSpeed(initialSpeed)
+    {
+        wheelMu.fill(1.0);
+        for (auto& w : wheels) {
+            w.angularVelocity = initialSpeed / kWheelRadius;
+            w.brakeTorque     = 0.0;
+            w.driveTorque     = 0.0;
+            w.rotationAngle   = 0.0;
+        }
+    }
+
+    void update(double dt)
+    {
+        if (dt <= 0.0) return;
+
+        // Sum friction forces from each wheel => netForce => update linearSpeed
+        double totalForce = 0.0;
+        forEachWheel([&](int i) {
+            double absSlip = std::fabs(computeSlipRatio(i));
+            double mu = frictionCoefficient(i, absSlip);
+            double frictionForce = mu * kNormalForce;
+
+            double diff = wheels[i].angularVelocity * kWheelRadius - linearSpeed;
+            totalForce += (diff >= 0.0) ? frictionForce : -frictionForce;
+        });
+
+        double accel = totalForce / kMass;
+        linearSpeed += accel * dt;
+        if (linearSpeed < 0.0) {
+            linearSpeed = 0.0; // no reversing in this demo
+        }
+
+        // Now update each wheel's angular velocity from net torque
+        forEachWheel([&](int i) {
+            Wheel& w = wheels[i];
+            double wheelLinSpeed = w.angularVelocity * kWheelRadius;
+            double diff          = wheelLinSpeed - linearSpeed;
+
+            double absSlip = std::fabs(diff / std::max(linearSpeed, 0.001));
+            double mu = frictionCoefficient(i, absSlip);
+            double frictionForce = mu * kNormalForce;
+
+            double sign = (wheelLinSpeed >= linearSpeed) ? 1.0 : -1.0;
+            double frictionTorque = frictionForce * kWheelRadius * sign;
+
+            double netTorque = w.driveTorque - w.brakeTorque - frictionTorque;
+            double alpha     = netTorque / kWheelInertia;
+
+            w.angularVelocity += alpha * dt;
+            if (w.angularVelocity < 0.0) {
+                w.angularVelocity = 0.0;
+            }
+
+            w.rotationAngle += w.angularVelocity * dt;
+            if (w.rotationAngle > 2.0 * M_PI) {
+                w.rotationAngle = std::fmod(w.rotationAngle, 2.0 * M_PI);
+            }
+        });
+    }
+
+    double getLinearSpeed() const { return linearSpeed; }
+    const std::array<Wheel, N>& getWheels() const { return wheels; }
+
+    void setBrakeTorque(int wheelIndex, double torque)
+    {
+        assert(wheelIndex >= 0 && wheelIndex < N);
+        wheels[wheelIndex].brakeTorque = std::max(0.0, torque);
+    }
+
+    void setDriveTorque(int wheelIndex, double torque)
+    {
+        assert(wheelIndex >= 0 && wheelIndex < N);
+        wheels[wheelIndex].driveTorque = std::max(0.0, torque);
+    }
+
+    void setFriction(double friction) { wheelMu.fill(friction); }
+
+    void setWheelFriction(int wheelIndex, double friction)
+    {
+        assert(wheelIndex >= 0 && wheelIndex < N);
+        wheelMu[wheelIndex] = friction;
+    }
+
+    // nullptr (the default) evaluates the exponential model exactly
+    void setTireModel(std::shared_ptr<const FrictionTable> table) { tireTable = std::move(table); }
+
+    // Replaces the dynamic state (speed and wheels), e.g. from a snapshot
+    void restoreState(double speed, const Wheel* newWheels, [[maybe_unused]] int numWheels)
+    {
+        assert(numWheels == N);
+        linearSpeed = speed;
+        std::copy(newWheels, newWheels + N, wheels.begin());
+    }
+
+    double computeSlipRatio(int wheelIndex) const
+    {
+        assert(wheelIndex >= 0 && wheelIndex < N);
+        double wheelLinSpeed = wheels[wheelIndex].angularVelocity * kWheelRadius;
+        double denom = std::max(linearSpeed, 0.001);
+        return (wheelLinSpeed - linearSpeed) / denom;
+    }
+
+    // Calls f(0), f(1), ..., f(N - 1), expanded at compile time
+    template <typename F>
+    static void forEachWheel(F&& f)
+    {
+        forEachWheel(f, std::make_integer_sequence<int, N>());
+    }
+
+private:
+    double linearSpeed;
+    std::array<Wheel, N> wheels;
+    std::shared_ptr<const FrictionTable> tireTable;
+    std::array<double, N> wheelMu;  // road friction under each wheel
+
+    double frictionCoefficient(int i, double absSlip) const
+    {
+        if (tireTable) {
+            return wheelMu[i] * tireTable->lookup(absSlip);
+        }
+        return wheelMu[i] * (1.0 - std::exp(-kFrictionShape * absSlip));
+    }
+
+    template <typename F, int... I>
+    static void forEachWheel(F& f, std::integer_sequence<int, I...>)
+    {
+        (f(I), ...);
+    }
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+#include "TractionControl.h"
+#include "VehicleFleet.h"
+
+// TractionControl for every wheel of a VehicleFleet at once.
+//
+// The per-wheel branch of TractionControl::update is rewritten without
+// branches: both sides compute the same candidate torque (b + kB e dt for
+// the brake, d - kD e dt for the drive), and the sign of the slip error
+// only decides which limit (maxBrakeTorque or maxDriveTorque) applies, so
+// the kernel is a handful of multiplies, min/max and blends per wheel. It
+// uses the same instruction set as the VehicleFleet kernels and gives the
+// same torques as TractionControl bit for bit (same FMA caveat as
+// VehicleFleet).
+class FleetTractionControl {
+public:
+    FleetTractionControl(int numVehicles, int numWheels, double desiredSlip = 0.1,
+                         const TractionGains& gains = TractionGains());
+
+    void setDesiredSlip(int v, double slip);
+
+    // The fleet must have the vehicle and wheel counts given to the
+    // constructor; otherwise nothing is updated and an error is printed
+    void update(VehicleFleet& fleet, double dt);
+
+private:
+    int numWheels;
+    TractionGains gains;
+    std::vector<double> desiredSlip;  // per wheel
+    std::vector<double> slip;         // scratch, per wheel
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "Vehicle.h"
+#include "SpscRing.h"
+#include "MappedFile.h"
+
+// One vehicle at the end of one physics step (152 bytes). Wheels beyond
+// kMaxWheels are not recorded.
+struct TelemetryRecord {
+    static constexpr int kMaxWheels = 8;
+
+    double   time;         // simulated seconds
+    uint64_t step;
+    uint16_t vehicle;
+    uint8_t  numWheels;    // recorded wheels
+    uint8_t  reserved;
+    float    linearSpeed;  // m/s
+    float    wheelSpeed[kMaxWheels];   // rad/s
+    float    slip[kMaxWheels];
+    float    driveTorque[kMaxWheels];  // N·m
+    float    brakeTorque[kMaxWheels];  // N·m
+};
+static_assert(std::is_trivially_copyable<TelemetryRecord>::value, "records are copied with memcpy");
+static_assert(sizeof(TelemetryRecord) == 152, "telemetry records have no padding");
+
+// Fills every field of `out` from the vehicle's current state
+void captureTelemetry(const Vehicle& vehicle, int vehicleIndex, uint64_t step, double time,
+                      TelemetryRecord& out);
+
+struct FlightRecorderOptions {
+    double historySeconds = 60.0;   // rolling window kept in the mapped file
+    double dumpSeconds    = 10.0;   // window saved by a trigger
+    double slipTrigger    = 0.0;    // |slip| above this on any wheel triggers a dump (0 = off)
+    int    queueRecords   = 8192;   // in flight between the physics and the writer thread
+};
+
+// Per-step telemetry for a running simulation.
+//
+// record() copies a compact record into a lock-free SPSC ring and never
+// waits, allocates or makes a system call; if the ring is full the record
+// is dropped and counted. A background thread drains the ring into a
+// memory-mapped file holding the last historySeconds as a circular buffer,
+// so the history survives a crash of the process. trigger() (or a wheel
+// slipping past slipTrigger) saves the dumpSeconds up to the trigger to
+// <path>_dump<N>.tcfr; triggers within dumpSeconds of the previous dump are
+// ignored, so a long slip episode is saved once per window.
+//
+// File ("TCFR" version 1): a 64-byte header (char[4] magic, uint32 version,
+// uint32 record size, uint32 vehicles per step, uint64 capacity, uint64
+// count, double physics dt, byte[24] reserved) followed by `capacity` raw
+// TelemetryRecord slots; record i is in slot i % capacity. Dumps use the
+// same format with capacity == count.
+class FlightRecorder {
+public:
+    FlightRecorder() = default;
+    ~FlightRecorder();
+
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    // vehiclesPerStep sizes the windows in records
+    bool open(const std::string& path, double physicsDt, int vehiclesPerStep,
+              const FlightRecorderOptions& options = FlightRecorderOptions());
+
+    // Producer side (one thread, e.g. the physics thread)
+    void record(const Vehicle& vehicle, int vehicleIndex, uint64_t step, double time);
+
+    // Any thread; the dump ends at the newest record written so far
+    void trigger() { requestDump(UINT64_MAX); }
+
+    // Drains the ring, stops the writer and unmaps the file; false if a
+    // dump failed
+    bool close();
+
+    bool isOpen() const { return writer.joinable(); }
+    uint64_t recordsWritten() const { return written.load(std::memory_order_relaxed); }
+    uint64_t recordsDropped() const { return dropped.load(std::memory_order_relaxed); }
+    int dumpsWritten() const { return dumps.load(std::memory_order_relaxed); }
+
+    // Records of a flight recorder or dump file, oldest first
+    static bool load(const std::string& path, std::vector<TelemetryRecord>& out);
+
+private:
+    std::string path;
+    MappedFile file;
+    std::unique_ptr<SpscRing<TelemetryRecord>> ring;
+    TelemetryRecord* slots = nullptr;  // in the mapping
+    uint64_t capacity = 0;
+    uint64_t dumpRecords = 0;
+    uint64_t nextDump = 0;  // earliest record count for the next dump
+    float slipTrigger = 0.0f;
+    bool failed = false;
+
+    std::atomic<bool> stopping{false};
+    std::atomic<uint64_t> dumpEnd{0};  // record count a dump ends at, 0 = none
+    std::atomic<uint64_t> written{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<int> dumps{0};
+    std::thread writer;
+
+    void requestDump(uint64_t end)
+    {
+        // The first trigger wins until the writer takes it
+        uint64_t none = 0;
+        if (dumpEnd.load(std::memory_order_relaxed) == 0) {
+            dumpEnd.compare_exchange_strong(none, end, std::memory_order_release, std::memory_order_relaxed);
+        }
+    }
+
+    void writeLoop();
+    std::size_t drain();  // returns the records written
+    bool writeDump(uint64_t end);
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct FrameRecorderOptions {
+    int  fps          = 50;     // frame rate stored in a Y4M header
+    int  queueFrames  = 8;      // frames buffered between the renderer and the writer
+    bool dropWhenFull = false;  // drop frames instead of waiting for the writer
+};
+
+// Writes rendered frames to disk on a background thread.
+//
+// The renderer fills an RGB24 frame (width * height * 3 bytes, rows top to
+// bottom, no padding) from acquireFrame() and hands it over with
+// submitFrame(). At most queueFrames frames are in flight; when they are all
+// taken, acquireFrame() waits for the writer or, with dropWhenFull, returns
+// nullptr and counts the frame as dropped. Needs no SDL, so it also works
+// with any other frame source.
+class FrameRecorder {
+public:
+    FrameRecorder() = default;
+    ~FrameRecorder();
+
+    FrameRecorder(const FrameRecorder&) = delete;
+    FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+    // "*.y4m" writes one uncompressed YUV4MPEG2 video (4:2:0, BT.601);
+    // "*.png" writes numbered images: run.png -> run_000000.png, ...
+    bool open(const std::string& path, int width, int height,
+              const FrameRecorderOptions& options = FrameRecorderOptions());
+
+    // Producer side (one thread)
+    uint8_t* acquireFrame();
+    void submitFrame();
+
+    // Writes the queued frames and stops the writer; false if any write failed
+    bool close();
+
+    bool isOpen() const { return writer.joinable(); }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    long long framesWritten() const;
+    long long framesDropped() const;
+
+    // Standalone encoders, also used by the writer thread
+    static bool writePng(const std::string& path, const uint8_t* rgb, int width, int height);
+    static void rgbToYuv420(const uint8_t* rgb, int width, int height, uint8_t* yuv);
+
+private:
+    enum class Format { Y4m, Png };
+
+    Format format = Format::Y4m;
+    std::string path;
+    int width = 0;
+    int height = 0;
+    std::FILE* video = nullptr;
+
+    std::vector<std::vector<uint8_t>> buffers;
+    std::deque<int> freeFrames;
+    std::deque<int> readyFrames;
+    int current = -1;  // acquired by the producer, not submitted yet
+    bool dropWhenFull = false;
+    bool stopping = false;
+    bool failed = false;
+    long long written = 0;
+    long long dropped = 0;
+
+    mutable std::mutex mutex;
+    std::condition_variable frameReady;
+    std::condition_variable frameFree;
+    std::thread writer;
+
+    void writeLoop();
+    bool writeFrame(const uint8_t* rgb, long long index, std::vector<uint8_t>& scratch);
+};
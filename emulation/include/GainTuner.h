@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "BatchSimulation.h"
+
+// Scores of one set of TractionControl gains (lower is better for both)
+struct TuningResult {
+    TractionGains gains;
+    double slipError;         // mean |slip - desired| over the traction scenarios
+    double stoppingDistance;  // mean meters to stop over the braking scenarios
+};
+
+// Searches the TractionControl gain space. Every candidate is run through the
+// same set of headless scenarios on a road friction x initial speed grid:
+//  - traction: drive away targeting +desired slip, scored by slip-tracking error
+//  - braking:  target -desired slip until the car stops, scored by distance
+// All candidates of a search step go to BatchSimulation as one parallel batch,
+// so results are deterministic for a given seed whatever the thread count.
+class GainTuner {
+public:
+    GainTuner(int numThreads = 0, std::uint64_t seed = 0, double frictionNoise = 0.0);
+
+    // Inclusive search box; the defaults bracket the hand-tuned TractionGains
+    void setBounds(const TractionGains& lo, const TractionGains& hi) { lower = lo; upper = hi; }
+
+    std::vector<TuningResult> evaluate(const std::vector<TractionGains>& candidates);
+
+    // pointsPerAxis^4 candidates on a regular grid
+    std::vector<TuningResult> gridSearch(int pointsPerAxis);
+
+    // Uniform samples in the search box
+    std::vector<TuningResult> randomSearch(int samples);
+
+    // `runs` CMA-ES instances, each minimizing a different weighting of the
+    // two normalized objectives so together they trace the Pareto front.
+    // The instances advance in lockstep and share one batch per generation.
+    std::vector<TuningResult> cmaEs(int generations, int population = 0, int runs = 5);
+
+    // Non-dominated results, sorted by slip error
+    static std::vector<TuningResult> paretoFront(const std::vector<TuningResult>& results);
+
+    const BatchStats& totalStats() const { return stats; }
+
+private:
+    BatchSimulation batch;
+    std::uint64_t seed;
+    double frictionNoise;
+    TractionGains lower, upper;
+    std::vector<Scenario> scenarios;  // per-candidate scenario set
+    int tractionScenarios = 0;        // the first ones; the rest are braking
+    BatchStats stats;
+
+    // Gains <-> unit cube [0, 1]^4
+    TractionGains fromUnit(const std::vector<double>& u) const;
+};
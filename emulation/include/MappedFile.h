@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Memory mapping of a whole file (mmap / MapViewOfFile): read-only, or a
+// new file of a given size that is written through the mapping.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    // Creates (or truncates) the file with `size` zero bytes, mapped writable
+    bool create(const std::string& path, std::size_t size);
+    void close();
+
+    // Starts writing dirty pages back to the file without waiting for it
+    void flush();
+
+    bool isOpen() const { return data != nullptr; }
+    const unsigned char* getData() const { return data; }
+    unsigned char* getWritableData() const { return writable ? data : nullptr; }
+    std::size_t getSize() const { return size; }
+
+private:
+    unsigned char* data = nullptr;
+    std::size_t size = 0;
+    bool writable = false;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
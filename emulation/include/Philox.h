@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel random
+// numbers: as easy as 1, 2, 3", SC'11). The output block is a pure function
+// of (key, counter), so any stream can be generated independently of the
+// others, in any order and on any thread.
+class Philox4x32 {
+public:
+    using Block = std::array<std::uint32_t, 4>;
+
+    explicit Philox4x32(std::uint64_t key)
+        : key0((std::uint32_t)key), key1((std::uint32_t)(key >> 32))
+    {}
+
+    Block operator()(Block counter) const
+    {
+        std::uint32_t k0 = key0, k1 = key1;
+        for (int round = 0; round < 10; round++) {
+            if (round > 0) {
+                k0 += kWeyl0;
+                k1 += kWeyl1;
+            }
+            std::uint64_t p0 = (std::uint64_t)kMul0 * counter[0];
+            std::uint64_t p1 = (std::uint64_t)kMul1 * counter[2];
+            counter = {(std::uint32_t)(p1 >> 32) ^ counter[1] ^ k0, (std::uint32_t)p1,
+                       (std::uint32_t)(p0 >> 32) ^ counter[3] ^ k1, (std::uint32_t)p0};
+        }
+        return counter;
+    }
+
+private:
+    static constexpr std::uint32_t kMul0  = 0xD2511F53;
+    static constexpr std::uint32_t kMul1  = 0xCD9E8D57;
+    static constexpr std::uint32_t kWeyl0 = 0x9E3779B9;
+    static constexpr std::uint32_t kWeyl1 = 0xBB67AE85;
+
+    std::uint32_t key0, key1;
+};
+
+// Sequential draws from stream `stream` of a Philox4x32 keyed by the seed.
+// The conversions to floating point and integer ranges are spelled out (not
+// std:: distributions) so the values are identical on every standard library.
+class PhiloxStream {
+public:
+    PhiloxStream(std::uint64_t seed, std::uint64_t stream)
+        : philox(seed), stream(stream)
+    {}
+
+    std::uint64_t next64()
+    {
+        if (used == 4) {
+            block = philox({(std::uint32_t)stream, (std::uint32_t)(stream >> 32),
+                            (std::uint32_t)index, (std::uint32_t)(index >> 32)});
+            index++;
+            used = 0;
+        }
+        std::uint64_t value = ((std::uint64_t)block[used] << 32) | block[used + 1];
+        used += 2;
+        return value;
+    }
+
+    // Uniform in [lo, hi) with 53 random bits
+    double uniform(double lo, double hi)
+    {
+        double unit = (double)(next64() >> 11) * 0x1.0p-53;
+        return lo + (hi - lo) * unit;
+    }
+
+    // Uniform integer in [lo, hi] (multiply-shift; bias below 2^-32 for small ranges)
+    int uniformInt(int lo, int hi)
+    {
+        std::uint64_t span = (std::uint64_t)((std::int64_t)hi - lo + 1);
+        std::uint64_t r = next64() >> 32;
+        return (int)(lo + (std::int64_t)((r * span) >> 32));
+    }
+
+private:
+    Philox4x32 philox;
+    std::uint64_t stream;
+    std::uint64_t index = 0;
+    Philox4x32::Block block{};
+    int used = 4;
+};
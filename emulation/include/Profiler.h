@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Log-linear latency histogram in nanoseconds (HDR-histogram style).
+//
+// Values below kSubBuckets are counted exactly; above that every power of two
+// is split into kSubBuckets / 2 linear buckets, so any recorded value is off
+// by at most ~3%. The range covers the full int64 nanosecond range.
+//
+// record() must only be called from one thread (each thread owns its own
+// histograms); it uses relaxed loads and stores, no locked instructions.
+// The statistics can be read from any thread at any time.
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 6;
+    static constexpr int kSubBuckets    = 1 << kSubBucketBits;
+    static constexpr int kNumBuckets    = kSubBuckets + (63 - kSubBucketBits + 1) * (kSubBuckets / 2);
+
+    // deadlineSeconds <= 0 disables deadline-miss counting
+    explicit LatencyHistogram(std::string name, double deadlineSeconds = 0.0);
+
+    void record(int64_t nanos)
+    {
+        uint64_t value = nanos > 0 ? static_cast<uint64_t>(nanos) : 0;
+        bump(counts[bucketIndex(value)]);
+        bump(total);
+        if (deadlineNanos > 0 && nanos > deadlineNanos) {
+            bump(misses);
+        }
+        if (nanos > maxNanos.load(std::memory_order_relaxed)) {
+            maxNanos.store(nanos, std::memory_order_relaxed);
+        }
+    }
+
+    const std::string& getName() const { return name; }
+    double getDeadlineSeconds() const { return deadlineNanos * 1e-9; }
+    uint64_t getCount() const { return total.load(std::memory_order_relaxed); }
+    uint64_t getDeadlineMisses() const { return misses.load(std::memory_order_relaxed); }
+    int64_t getMaxNanos() const { return maxNanos.load(std::memory_order_relaxed); }
+
+    // Upper bound of the bucket holding the given quantile (0..1), in ns
+    int64_t percentileNanos(double quantile) const;
+
+private:
+    std::string name;
+    int64_t deadlineNanos;
+
+    std::array<std::atomic<uint64_t>, kNumBuckets> counts;
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<int64_t>  maxNanos{0};
+
+    static void bump(std::atomic<uint64_t>& counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    static int bucketIndex(uint64_t value);
+    static uint64_t bucketUpperBound(int index);
+};
+
+// Records the lifetime of the scope into a histogram.
+class ScopedTimer {
+public:
+    using clock = std::chrono::steady_clock;
+
+    explicit ScopedTimer(LatencyHistogram& histogram)
+        : histogram(histogram), start(clock::now())
+    {}
+
+    ~ScopedTimer()
+    {
+        histogram.record(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count());
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    LatencyHistogram& histogram;
+    clock::time_point start;
+};
+
+// Owns the histograms of a run and prints them as a table.
+class Profiler {
+public:
+    // Register all histograms before the threads that record into them start.
+    LatencyHistogram& add(const std::string& name, double deadlineSeconds = 0.0);
+
+    // p50 / p99 / p99.9 / max and deadline misses per histogram. Can be
+    // called at any time, also while the histograms are being recorded.
+    void report(std::ostream& out) const;
+
+private:
+    std::vector<std::unique_ptr<LatencyHistogram>> histograms;
+};
@@ -1,20 +1,82 @@
 #pragma once
 
 #include <memory>
+#include <ostream>
+#include <vector>
 #include "Vehicle.h"
 #include "TractionControl.h"
 #include "Visualizer.h"
+#include "FixedStepLoop.h"
+#include "TripleBuffer.h"
+#include "Profiler.h"
+#include "FlightRecorder.h"
+
+struct SimulationOptions {
+    double timeScale = 1.0;  // simulated seconds per wall second; <= 0 runs as fast as possible
+    double duration  = 0.0;  // simulated seconds to run; 0 runs until the window is closed
+    double frameRate = 50.0; // offscreen frames per simulated second
+};
 
 class Simulation {
 public:
+    static constexpr double kPhysicsDt = 0.01;  // 10 ms
+
+    // A null or offscreen visualizer needs a duration to stop.
     Simulation(std::shared_ptr<Vehicle> vehicle,
                std::shared_ptr<TractionControl> tc,
-               std::shared_ptr<Visualizer> vis);
+               std::shared_ptr<Visualizer> vis,
+               const SimulationOptions& options = SimulationOptions());
 
+    // Several vehicles, one controller each, stepped together and drawn side
+    // by side in one window
+    Simulation(std::vector<std::shared_ptr<Vehicle>> vehicles,
+               std::vector<std::shared_ptr<TractionControl>> controllers,
+               std::shared_ptr<Visualizer> vis,
+               const SimulationOptions& options = SimulationOptions());
+
+    // Runs physics and control on their own thread at 100 Hz of simulated
+    // time and renders the latest published state on the calling thread
+    // until the window is closed or the duration has been simulated.
+    // With an offscreen visualizer both run on the calling thread instead,
+    // rendering every 1 / frameRate simulated seconds as fast as possible, so
+    // a recording has the same frames however slow the machine is.
     void run();
 
+    StepStats getPhysicsStats() const { return physics.getStats(); }
+
+    // Records every vehicle after every physics step; set before run()
+    void setFlightRecorder(std::shared_ptr<FlightRecorder> recorder) { flightRecorder = std::move(recorder); }
+
+    // Frames per simulated second actually rendered offscreen: frameRate
+    // rounded to a whole number of physics steps per frame
+    double getOffscreenFrameRate() const { return 1.0 / (offscreenStepsPerFrame() * kPhysicsDt); }
+
+    // Latency of the control, physics and render phases. Safe to call while
+    // running; also printed on exit and when P is pressed in the window.
+    void reportLatency(std::ostream& out) const { profiler.report(out); }
+
 private:
-    std::shared_ptr<Vehicle> vehicle;
-    std::shared_ptr<TractionControl> tractionControl;
+    std::vector<std::shared_ptr<Vehicle>> vehicles;
+    std::vector<std::shared_ptr<TractionControl>> controllers;
     std::shared_ptr<Visualizer> visualizer;
+    SimulationOptions options;
+    std::shared_ptr<FlightRecorder> flightRecorder;
+
+    FixedStepLoop physics;
+    TripleBuffer<std::vector<Vehicle>> snapshots;  // physics thread -> renderer
+    long long maxSteps;               // 0 = unlimited
+    long long stepCount = 0;          // physics thread (or offscreen loop) only
+
+    // Control, physics and step are recorded by the physics thread, render
+    // by the calling thread
+    Profiler profiler;
+    LatencyHistogram& controlTime;
+    LatencyHistogram& physicsTime;
+    LatencyHistogram& stepTime;
+    LatencyHistogram& renderTime;
+
+    bool step();
+    long long offscreenStepsPerFrame() const;
+    void renderLoop();
+    void renderOffscreen();
 };
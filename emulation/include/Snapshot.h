@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "Vehicle.h"
+#include "TractionControl.h"
+
+// Full state of a Vehicle + TractionControl pair as one fixed-size POD, so
+// a what-if branch (e.g. a friction drop at t = 3 s) starts from a copy of a
+// warmed-up state instead of replaying from t = 0. The tire table is
+// configuration, not state, and is not captured.
+struct SimulationSnapshot {
+    static constexpr int kMaxWheels = 8;
+
+    double   time;           // simulated seconds
+    uint32_t numWheels;
+    uint32_t reserved;
+
+    // Vehicle
+    double linearSpeed;
+    double wheelRadius;
+    double mass;
+    double wheelInertia;
+    double muPeak;
+    double slipOpt;
+    Vehicle::Wheel wheels[kMaxWheels];
+
+    // Controller
+    double desiredSlip;
+    TractionGains gains;
+};
+static_assert(std::is_trivially_copyable<SimulationSnapshot>::value, "snapshots are copied with memcpy");
+
+// False if the vehicle has more than kMaxWheels wheels
+bool captureSnapshot(const Vehicle& vehicle, const TractionControl& tc, double time,
+                     SimulationSnapshot& out);
+
+// Rebuild the vehicle and controller of a snapshot
+Vehicle restoreVehicle(const SimulationSnapshot& snapshot);
+TractionControl restoreController(const SimulationSnapshot& snapshot);
+
+// Snapshot file ("TCSN" version 1): a 32-byte header (char[4] magic,
+// uint32 version, uint32 record size, uint32 reserved, uint64 count,
+// byte[8] reserved) followed by `count` raw SimulationSnapshot records in
+// host byte order (little-endian on every supported platform).
+bool saveSnapshots(const std::string& path, const SimulationSnapshot* snapshots, std::size_t count);
+bool loadSnapshots(const std::string& path, std::vector<SimulationSnapshot>& out);
+
+// Copy-on-write array of snapshots for large batches of branches.
+//
+// Snapshots live in fixed-size pages shared between arenas: fork() and
+// repeat() only copy page pointers, and a page is duplicated the first time
+// a shared page is written through at(). Thousands of branches of one state
+// therefore cost one page until they are modified. Concurrent reads are
+// fine; writes need external synchronization.
+class SnapshotArena {
+public:
+    static constexpr std::size_t kPageSnapshots = 64;
+
+    SnapshotArena() = default;
+
+    // `count` copies of one snapshot, all on a single shared page
+    static SnapshotArena repeat(const SimulationSnapshot& snapshot, std::size_t count);
+
+    std::size_t size() const { return count; }
+
+    void push(const SimulationSnapshot& snapshot);
+
+    const SimulationSnapshot& operator[](std::size_t i) const
+    {
+        return pages[i / kPageSnapshots]->snapshots[i % kPageSnapshots];
+    }
+
+    // Writable access; copies the page first if another arena (or another
+    // slot of this one) shares it
+    SimulationSnapshot& at(std::size_t i);
+
+    // Cheap copy sharing every page
+    SnapshotArena fork() const { return *this; }
+
+    // Pages not shared with anything else (diagnostics)
+    std::size_t uniquePages() const;
+    std::size_t numPages() const { return pages.size(); }
+
+private:
+    struct Page {
+        SimulationSnapshot snapshots[kPageSnapshots];
+    };
+
+    std::vector<std::shared_ptr<Page>> pages;
+    std::size_t count = 0;
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// Bounded lock-free queue for one producer and one consumer thread.
+//
+// The capacity is rounded up to a power of two. Each side owns one
+// monotonically increasing index and only reads the other side's index when
+// its cached copy says the queue looks full (producer) or empty (consumer),
+// so a push is a copy plus one release store in the common case. Neither
+// side ever waits: push() on a full queue returns false.
+template <typename T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable<T>::value, "records are copied between threads");
+
+public:
+    explicit SpscRing(std::size_t minCapacity)
+    {
+        std::size_t capacity = 2;
+        while (capacity < minCapacity) capacity *= 2;
+        slots.resize(capacity);
+        mask = capacity - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    std::size_t capacity() const { return slots.size(); }
+
+    // Producer side
+    bool push(const T& value)
+    {
+        T* slot = claim();
+        if (!slot) return false;
+        *slot = value;
+        publish();
+        return true;
+    }
+
+    // Or fill the next slot in place: claim() returns nullptr if the queue
+    // is full, and publish() hands the claimed slot to the consumer
+    T* claim()
+    {
+        uint64_t tail = writeIndex.load(std::memory_order_relaxed);
+        if (tail - cachedRead > mask) {
+            cachedRead = readIndex.load(std::memory_order_acquire);
+            if (tail - cachedRead > mask) return nullptr;
+        }
+        return &slots[tail & mask];
+    }
+
+    // Values published so far
+    uint64_t published() const { return writeIndex.load(std::memory_order_relaxed); }
+
+    void publish()
+    {
+        writeIndex.store(writeIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Consumer side: copies up to `max` values to `out`, returns how many
+    std::size_t pop(T* out, std::size_t max)
+    {
+        uint64_t head = readIndex.load(std::memory_order_relaxed);
+        if (cachedWrite == head) {
+            cachedWrite = writeIndex.load(std::memory_order_acquire);
+        }
+        std::size_t count = (std::size_t)(cachedWrite - head);
+        if (count > max) count = max;
+        for (std::size_t i = 0; i < count; i++) {
+            out[i] = slots[(head + i) & mask];
+        }
+        readIndex.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+private:
+    std::vector<T> slots;
+    uint64_t mask = 0;
+
+    // Each index with the other side's cached copy, on separate cache lines
+    alignas(64) std::atomic<uint64_t> writeIndex{0};
+    uint64_t cachedRead = 0;   // producer only
+    alignas(64) std::atomic<uint64_t> readIndex{0};
+    uint64_t cachedWrite = 0;  // consumer only
+};
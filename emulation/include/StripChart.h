@@ -0,0 +1,62 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <vector>
+
+// Scrolling time-series plot of a few traces, one texture column per time
+// slot.
+//
+// Samples are reduced to a min/max range per trace and column, kept in a
+// fixed-size history of `columns` slots. The texture is a ring as well: a
+// finished column is written into its slot of a streaming texture (one
+// narrow SDL_LockTexture per frame, however many samples arrived), and
+// draw() scrolls by copying the two halves of the ring side by side. Only
+// when a value leaves the vertical range is everything redrawn, at twice
+// the range, from the history.
+class StripChart {
+public:
+    // lo..hi is the initial vertical range; a symmetric chart grows both
+    // ends together and shows a zero line
+    StripChart(SDL_Renderer* renderer, int columns, int height, int traces,
+               double lo, double hi, bool symmetric);
+    ~StripChart();
+
+    StripChart(const StripChart&) = delete;
+    StripChart& operator=(const StripChart&) = delete;
+
+    void setTraceColor(int trace, Uint8 r, Uint8 g, Uint8 b);
+
+    // One value per trace for absolute time slot `column`; slots never move
+    // backwards, and skipped slots are left empty
+    void addSample(long long column, const float* values);
+
+    // Uploads finished columns and draws the history, newest at the right
+    void draw(const SDL_Rect& dst);
+
+private:
+    SDL_Renderer* renderer;
+    SDL_Texture* texture = nullptr;
+    int columns;
+    int height;
+    int traces;
+    double lo, hi;
+    bool symmetric;
+    std::vector<Uint32> colors;
+
+    // History: [slot * traces + trace], valid[slot] = 0 for empty slots
+    std::vector<float> minValue;
+    std::vector<float> maxValue;
+    std::vector<uint8_t> valid;
+
+    long long current = -1;  // slot being accumulated
+    long long dirtyFrom = 0; // first finished slot not uploaded yet
+    bool redraw = true;      // the whole texture is stale
+
+    void clearSlot(long long column);
+    void drawColumn(long long column, Uint32* pixels, int pitch);
+    void upload(long long from, long long to);
+    void growRange(float value);
+    int toY(double value) const;
+    int slotOf(long long column) const { return (int)(((column % columns) + columns) % columns); }
+};
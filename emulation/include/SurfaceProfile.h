@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class MappedFile;
+
+// Road friction along the track: mu as a function of travelled distance, for
+// one lane (the whole road) or two (left and right wheels, for split-mu).
+//
+// A profile is a list of points (distance, mu of every lane) sorted by
+// distance. Mu is interpolated linearly between points and held constant
+// before the first and after the last one; two points at the same distance
+// make a step, e.g. the edge of an ice patch. Wheels map to lanes like the
+// visualizer draws them: even indices on the left, odd on the right.
+class SurfaceProfile {
+public:
+    static constexpr int kMaxLanes = 2;
+
+    // An empty profile reads as a dry road (mu = 1) until points are added
+    explicit SurfaceProfile(int numLanes = 1);
+
+    // Points must come in non-decreasing distance; false (and nothing added)
+    // otherwise
+    bool addPoint(double distance, double mu);
+    bool addPoint(double distance, double leftMu, double rightMu);
+
+    // Presets. Outside the described section the road has friction `mu`.
+    static SurfaceProfile uniform(double mu);
+    static SurfaceProfile icePatch(double mu, double iceMu, double start, double length);
+    static SurfaceProfile wetTransition(double dryMu, double wetMu, double start, double width);
+    static SurfaceProfile splitMu(double mu, double leftMu, double rightMu, double start, double length);
+
+    // "ice", "wet", "split", or the path of a profile file; nullptr if the
+    // file cannot be read
+    static std::shared_ptr<SurfaceProfile> create(const std::string& spec);
+
+    // Profile file ("TCSF" version 1): a 32-byte header (char[4] magic,
+    // uint32 version, uint32 lanes, uint32 reserved, uint64 count,
+    // byte[8] reserved) followed by `count` points of 1 + lanes doubles
+    // (distance, then the mu of each lane) in host byte order. load() maps
+    // the file and reads the points in place.
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+
+    int getNumLanes() const { return numLanes; }
+    std::size_t size() const { return count; }
+
+    static int laneOf(int wheel, int numLanes) { return (numLanes == 2) ? wheel % 2 : 0; }
+
+    // Random access (binary search); use a Cursor along a run
+    double at(double distance, int lane) const;
+
+    // Remembers the segment of the last lookup, so a vehicle moving along
+    // the track pays O(1) amortized per step instead of a search. Valid as
+    // long as the profile is alive and unchanged.
+    class Cursor {
+    public:
+        explicit Cursor(const SurfaceProfile& profile);
+
+        void seek(double distance);
+
+        // Mu of a lane at the last seek() distance
+        double mu(int lane) const
+        {
+            if (!lo) return 1.0;
+            return lo[1 + lane] + t * (hi[1 + lane] - lo[1 + lane]);
+        }
+
+    private:
+        const double* points;
+        std::size_t   count;
+        int           stride;
+        std::size_t   segment = 0;
+        const double* lo = nullptr;
+        const double* hi = nullptr;
+        double        t = 0.0;
+    };
+
+private:
+    int numLanes;
+    std::size_t count = 0;
+    std::vector<double> owned;               // points built in memory
+    std::shared_ptr<MappedFile> mapping;     // or a mapped file
+    const double* mapped = nullptr;
+
+    int stride() const { return 1 + numLanes; }
+    const double* data() const { return mapping ? mapped : owned.data(); }
+    bool append(const double* point);
+};
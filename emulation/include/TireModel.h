@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Friction curve of a tire: the normalized friction coefficient as a function
+// of |slip|. Vehicles multiply it by the road's muPeak.
+class TireModel {
+public:
+    virtual ~TireModel() = default;
+
+    virtual double evaluate(double absSlip) const = 0;
+
+    // "exponential", "pacejka", or the path of a table file (see
+    // TabulatedTireModel). nullptr if the file cannot be read.
+    static std::shared_ptr<TireModel> create(const std::string& spec);
+};
+
+// mu = 1 - exp(-k |slip|), the original model of Vehicle::update
+class ExponentialTireModel : public TireModel {
+public:
+    static constexpr double kDefaultShape = 10.0;
+
+    explicit ExponentialTireModel(double shape = kDefaultShape) : shape(shape) {}
+
+    double evaluate(double absSlip) const override;
+
+private:
+    double shape;
+};
+
+// Pacejka "magic formula": mu = D sin(C atan(B s - E (B s - atan(B s))))
+// Defaults are typical longitudinal values for dry asphalt.
+class PacejkaTireModel : public TireModel {
+public:
+    explicit PacejkaTireModel(double B = 10.0, double C = 1.9, double D = 1.0, double E = 0.97)
+        : B(B), C(C), D(D), E(E)
+    {}
+
+    double evaluate(double absSlip) const override;
+
+private:
+    double B, C, D, E;
+};
+
+// Measured curve read from a text file with one "slip mu" pair per line
+// ('#' starts a comment), sorted by slip. Linear interpolation in between,
+// the first/last value outside the sampled range.
+class TabulatedTireModel : public TireModel {
+public:
+    bool load(const std::string& path);
+
+    double evaluate(double absSlip) const override;
+
+private:
+    std::vector<std::pair<double, double>> points;
+};
+
+// Any TireModel sampled on a uniform |slip| grid and linearly interpolated,
+// so a Pacejka or measured curve costs a couple of loads instead of
+// transcendental calls. Slips beyond maxSlip use the value at maxSlip.
+//
+// With the defaults (4096 samples up to |slip| = 5) the interpolation error
+// is about 2e-5 for the exponential model and 5e-5 for Pacejka.
+class FrictionTable {
+public:
+    static constexpr double kDefaultMaxSlip = 5.0;
+    static constexpr int    kDefaultSize    = 4096;
+
+    explicit FrictionTable(const TireModel& model,
+                           double maxSlip = kDefaultMaxSlip,
+                           int size = kDefaultSize);
+
+    double lookup(double absSlip) const
+    {
+        double x = absSlip * invStep;
+        if (!(x < lastIndex)) {
+            return values.back();  // beyond the table (or NaN)
+        }
+        if (x < 0.0) x = 0.0;
+        int i = (int)x;
+        double t = x - i;
+        return values[i] + t * (values[i + 1] - values[i]);
+    }
+
+    // Batch lookup (AVX2 gathers when available); mu may alias absSlip
+    void lookup(const double* absSlip, double* mu, std::size_t count) const;
+
+    // Largest |table - model| over `probes` evenly spaced slips in [0, maxSlip]
+    double maxError(const TireModel& model, int probes = 100000) const;
+
+private:
+    std::vector<double> values;
+    double maxSlip;
+    double invStep;
+    double lastIndex;
+};
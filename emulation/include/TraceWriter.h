@@ -0,0 +1,156 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// One row of the training dataset written by data_generator.
+struct TraceRecord {
+    int    wheelIndex;
+    double slipRatio;
+    double angularVelocity;
+    double linearSpeed;
+    double currentBrakeTorque;
+    double currentDriveTorque;
+    double desiredBrakeTorque;
+    double desiredDriveTorque;
+};
+
+// Output format of a trace. Sinks are only ever called from the writer thread.
+class TraceSink {
+public:
+    virtual ~TraceSink() = default;
+
+    virtual bool open(const std::string& path) = 0;
+    virtual bool write(const TraceRecord* records, std::size_t count) = 0;
+    virtual bool close() = 0;
+};
+
+// Text CSV with the same columns and 6 significant digits as the original
+// ostream output, formatted with std::to_chars into a large write buffer.
+class CsvTraceSink : public TraceSink {
+public:
+    explicit CsvTraceSink(std::size_t bufferBytes = 1 << 20);
+    ~CsvTraceSink() override;
+
+    bool open(const std::string& path) override;
+    bool write(const TraceRecord* records, std::size_t count) override;
+    bool close() override;
+
+private:
+    std::FILE* file = nullptr;
+    std::vector<char> buffer;
+    std::size_t used = 0;
+
+    bool flush();
+};
+
+// Columnar dataset file (see ColumnarDataset.h for the layout). Besides the
+// eight logged columns it stores the engineered features used for training:
+//   speed_to_velocity_ratio = linear_speed / (angular_velocity + 1e-6)
+//   excess_drive_torque     = current_drive_torque - desired_drive_torque
+//   slip_deviation          = slip_ratio - 0.1
+class BinaryTraceSink : public TraceSink {
+public:
+    explicit BinaryTraceSink(std::size_t chunkRows = 1 << 16);
+    ~BinaryTraceSink() override;
+
+    bool open(const std::string& path) override;
+    bool write(const TraceRecord* records, std::size_t count) override;
+    bool close() override;
+
+private:
+    std::FILE* file = nullptr;
+    std::size_t chunkRows;
+    std::vector<float> staging;     // one chunk, column-major
+    std::size_t stagedRows = 0;
+    unsigned long long numRows = 0;
+    std::vector<float> columnMin;
+    std::vector<float> columnMax;
+
+    bool flushChunk();
+};
+
+// Writes selected columns (any of the BinaryTraceSink columns, by name) of
+// each record as float32 rows into caller-owned buffers, e.g. NumPy arrays
+// filled in place by the tc_sim Python module. Each output is row-major
+// [capacity][columns.size()]; writing more than `capacity` rows fails.
+class MemoryTraceSink : public TraceSink {
+public:
+    struct Output {
+        float* data;
+        std::vector<int> columns;  // column indices, see columnIndex()
+    };
+
+    MemoryTraceSink(std::vector<Output> outputs, std::size_t capacity);
+
+    bool open(const std::string& path) override;
+    bool write(const TraceRecord* records, std::size_t count) override;
+    bool close() override { return true; }
+
+    std::size_t rowsWritten() const { return rows; }
+
+    // Index of a column name, -1 if unknown
+    static int columnIndex(const std::string& name);
+    static std::vector<std::string> columnNames();
+
+private:
+    std::vector<Output> outputs;
+    std::size_t capacity;
+    std::size_t rows = 0;
+};
+
+// Collects records into fixed-size chunks and hands full chunks to a
+// background thread that owns the sink, so the simulation never waits on
+// disk unless maxQueuedChunks chunks are already pending.
+class TraceWriter {
+public:
+    explicit TraceWriter(std::unique_ptr<TraceSink> sink,
+                         std::size_t chunkRecords = 1 << 16,
+                         std::size_t maxQueuedChunks = 4);
+    ~TraceWriter();
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    bool open(const std::string& path);
+
+    void push(const TraceRecord& record)
+    {
+        current.push_back(record);
+        if (current.size() >= chunkRecords) {
+            submit();
+        }
+    }
+
+    // Flushes pending records and joins the writer thread.
+    // Returns false if any write failed.
+    bool close();
+
+    // "csv" or "bin"; nullptr for unknown formats
+    static std::unique_ptr<TraceSink> makeSink(const std::string& format);
+
+private:
+    std::unique_ptr<TraceSink> sink;
+    std::size_t chunkRecords;
+    std::size_t maxQueuedChunks;
+
+    std::vector<TraceRecord> current;
+
+    std::mutex mutex;
+    std::condition_variable queueChanged;
+    std::deque<std::vector<TraceRecord>> pending;
+    std::vector<std::vector<TraceRecord>> spare;  // recycled chunk buffers
+    bool closing = false;
+    bool failed = false;
+    std::thread worker;
+
+    void submit();
+    void run();
+};
@@ -2,19 +2,30 @@
 
 #include "Vehicle.h"
 
+// Torque limits and ramp rates of the rule-based controller (see tc_tune)
+struct TractionGains {
+    double maxBrakeTorque = 200.0;  // N·m
+    double maxDriveTorque = 150.0;  // N·m
+    double brakeRampRate  = 500.0;  // N·m per second
+    double driveRampRate  = 300.0;  // N·m per second
+};
+
 class TractionControl {
 public:
-    explicit TractionControl(double desiredSlip = 0.1);
+    explicit TractionControl(double desiredSlip = 0.1, const TractionGains& gains = TractionGains());
 
     // Called each physics step (or substep) to adjust drive/brake torque.
     void update(Vehicle& vehicle, double dt);
 
+    double getDesiredSlip() const { return desiredSlip; }
+    TractionGains getGains() const { return {maxBrakeTorque, maxDriveTorque, brakeRampRate, driveRampRate}; }
+
 private:
     double desiredSlip;
 
     // We'll store some internal parameters for ramping
     double maxBrakeTorque;
     double maxDriveTorque;
-    double brakeRampRate; 
-    double driveRampRate; 
+    double brakeRampRate;
+    double driveRampRate;
 };
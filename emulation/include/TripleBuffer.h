@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free triple buffer for one producer and one consumer thread.
+//
+// The producer fills writeBuffer() and calls publish(); the consumer calls
+// update() and reads readBuffer(). Each side owns one of the three slots and
+// the third is swapped through a single atomic, so neither side ever waits
+// and the consumer always sees the most recently published value. Values
+// published while the consumer is busy are simply overwritten.
+template <typename T>
+class TripleBuffer {
+public:
+    explicit TripleBuffer(const T& initial = T())
+        : buffers{initial, initial, initial}
+    {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Producer side
+    T& writeBuffer() { return buffers[back]; }
+
+    void publish()
+    {
+        uint8_t previous = middle.exchange(static_cast<uint8_t>(back | kFresh), std::memory_order_acq_rel);
+        back = previous & kIndexMask;
+    }
+
+    // Consumer side. Returns true if a new value was picked up.
+    bool update()
+    {
+        if (!(middle.load(std::memory_order_relaxed) & kFresh)) {
+            return false;
+        }
+        uint8_t previous = middle.exchange(static_cast<uint8_t>(front), std::memory_order_acq_rel);
+        front = previous & kIndexMask;
+        return true;
+    }
+
+    const T& readBuffer() const { return buffers[front]; }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh     = 0x4;  // middle slot holds unread data
+
+    T buffers[3];
+
+    // Slot indices; front and back are each touched by one thread only
+    alignas(64) std::atomic<uint8_t> middle{1};
+    alignas(64) uint8_t back = 0;
+    alignas(64) uint8_t front = 2;
+};
@@ -3,6 +3,9 @@
 #define _USE_MATH_DEFINES
 #include <vector>
 #include <cmath>
+#include <memory>
+#include <string>
+#include "TireModel.h"
 
 class Vehicle {
 public:
@@ -13,10 +16,38 @@ public:
         double rotationAngle;    // for rendering (accumulated rotation in radians)
     };
 
+    // How update() advances the wheel speeds. The slip ratio divides by the
+    // vehicle speed, so near standstill a wheel is very stiff and explicit
+    // Euler overshoots unless dt is tiny. The vehicle speed is less stiff (its
+    // mass is ~100x the wheel inertia seen at the road), so every scheme
+    // still advances it first with explicit Euler. The wheels then integrate
+    // against that new speed.
+    enum class Integrator {
+        Euler,              // explicit (the default, the original model)
+        SemiImplicitEuler,  // linearly implicit: one Newton step of backward Euler
+        RK4,                // classic fourth-order Runge-Kutta
+        Implicit            // backward Euler, solved to convergence
+    };
+
     Vehicle(double initialSpeed, int numWheels);
 
     void update(double dt);
 
+    // tolerance > 0 (rad/s) turns on adaptive substepping. Each wheel compares
+    // one step against two half steps, and halves its step while they differ
+    // by more than `tolerance`. The smallest step is dt / maxSubsteps, with
+    // maxSubsteps rounded down to a power of two. A wheel that agrees at the
+    // full dt is not split, so only the stiff wheels pay for substeps.
+    void setIntegrator(Integrator method, double tolerance = 0.0, int maxSubsteps = 64);
+    Integrator getIntegrator() const { return integrator; }
+
+    // Wheel steps accepted by the last update (the wheel count without substeps)
+    int getSubsteps() const { return substeps; }
+
+    // "euler", "semi-implicit", "rk4", "implicit"
+    static bool parseIntegrator(const std::string& name, Integrator& method);
+    static const char* integratorName(Integrator method);
+
     // Accessors
     double getLinearSpeed() const { return linearSpeed; }
     const std::vector<Wheel>& getWheels() const { return wheels; }
@@ -26,9 +57,23 @@ public:
     void setDriveTorque(int wheelIndex, double torque);
     void setFriction(double friction);
 
+    // Friction of a single wheel (split-mu roads, patches under one side);
+    // holds until the next setFriction, which makes the road uniform again
+    void setWheelFriction(int wheelIndex, double friction);
+    double getWheelFriction(int wheelIndex) const;
+
+    // Tire friction curve; nullptr (the default) evaluates the built-in
+    // exponential model exactly.
+    void setTireModel(std::shared_ptr<const FrictionTable> table) { tireTable = std::move(table); }
+
+    static constexpr double kFrictionShape = ExponentialTireModel::kDefaultShape;
+
     // Slip ratio for a single wheel
     double computeSlipRatio(int wheelIndex) const;
 
+    // Replaces the dynamic state (speed and wheels), e.g. from a snapshot
+    void restoreState(double speed, const Wheel* newWheels, int numWheels);
+
     double wheelRadius;   // wheel radius (meters)
     double mass;          // total vehicle mass (kg)
     double wheelInertia;  // moment of inertia per wheel (kg·m^2)
@@ -38,4 +83,31 @@ public:
 private:
     double linearSpeed;     // m/s, forward speed of the vehicle
     std::vector<Wheel> wheels;
+    std::shared_ptr<const FrictionTable> tireTable;
+    std::vector<double> wheelMu;  // per wheel; empty while every wheel uses muPeak
+
+    Integrator integrator = Integrator::Euler;
+    double tolerance = 0.0;
+    int maxLevel = 6;  // smallest substep is dt / 2^maxLevel
+    int substeps = 0;
+
+    // d(omega)/dt of wheel i at angular velocity omega, at the current vehicle
+    // speed, and its derivative with respect to omega (always <= 0 for a
+    // friction curve that rises with slip)
+    double wheelAcceleration(int i, double omega) const;
+    double wheelAccelerationSlope(int i, double omega) const;
+
+    double stepWheel(int i, double omega, double h) const;
+    double solveImplicit(int i, double omega, double h) const;
+    void integrateWheel(int i, double dt);
+
+    // Friction coefficient of wheel i for a given |slip|, up to its peak
+    double frictionCoefficient(int i, double absSlip) const
+    {
+        double peak = wheelMu.empty() ? muPeak : wheelMu[i];
+        if (tireTable) {
+            return peak * tireTable->lookup(absSlip);
+        }
+        return peak * (1.0 - std::exp(-kFrictionShape * absSlip));
+    }
 };
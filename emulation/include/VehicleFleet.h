@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "Vehicle.h"
+
+// Structure-of-arrays physics for N vehicles with W wheels each.
+//
+// Wheel data is stored flat at index (vehicle * W + wheel) so the per-wheel
+// work of Vehicle::update runs as one long SIMD loop across the whole fleet.
+// The kernel is chosen at compile time: AVX-512F, AVX2, or a scalar fallback
+// (build with ENABLE_NATIVE_ARCH=ON to get the vector paths).
+//
+// Accuracy: the scalar kernel performs the same operations in the same order
+// as Vehicle::update and matches it bit for bit (unless the compiler contracts
+// one side into FMAs). The vector kernels use a polynomial exp() accurate to
+// ~2 ulp, so individual steps agree to ~1e-15 relative; after 1000 coupled
+// steps with traction control in the loop, speeds, wheel velocities and
+// rotation angles stay within 1e-9 of the reference, relative to
+// max(|value|, 1e-3). BM_FleetControlledStep in tc_bench checks this.
+class VehicleFleet {
+public:
+    VehicleFleet(int numVehicles, int numWheels, double initialSpeed = 0.0);
+
+    // Copy the full state and parameters of one scalar Vehicle into slot v.
+    // The physical parameters are fleet-wide, so they are taken from the
+    // last loaded vehicle.
+    void loadVehicle(int v, const Vehicle& vehicle);
+
+    // Same integration as Vehicle::update, for every vehicle at once.
+    void update(double dt);
+
+    int getNumVehicles() const { return numVehicles; }
+    int getNumWheels() const { return numWheels; }
+    std::size_t index(int v, int w) const { return (std::size_t)v * numWheels + w; }
+
+    double getLinearSpeed(int v) const { return linearSpeed[v]; }
+    double getAngularVelocity(int v, int w) const { return angularVelocity[index(v, w)]; }
+    double getBrakeTorque(int v, int w) const { return brakeTorque[index(v, w)]; }
+    double getDriveTorque(int v, int w) const { return driveTorque[index(v, w)]; }
+    double getRotationAngle(int v, int w) const { return rotationAngle[index(v, w)]; }
+
+    void setBrakeTorque(int v, int w, double torque);
+    void setDriveTorque(int v, int w, double torque);
+    void setFriction(int v, double friction);
+    void setWheelFriction(int v, int w, double friction) { muPeak[index(v, w)] = friction; }
+
+    // Fleet-wide tire curve. With a table the friction coefficients are
+    // looked up (with AVX2 gathers when available) instead of running the
+    // exponential kernels, matching Vehicle with the same table (same FMA
+    // caveat as above); nullptr restores the exponential model.
+    void setTireModel(std::shared_ptr<const FrictionTable> table) { tireTable = std::move(table); }
+
+    double computeSlipRatio(int v, int w) const;
+
+    // Raw SoA arrays (numVehicles * numWheels entries, linearSpeed has numVehicles)
+    double* angularVelocityData() { return angularVelocity.data(); }
+    double* brakeTorqueData() { return brakeTorque.data(); }
+    double* driveTorqueData() { return driveTorque.data(); }
+    const double* angularVelocityData() const { return angularVelocity.data(); }
+    const double* brakeTorqueData() const { return brakeTorque.data(); }
+    const double* driveTorqueData() const { return driveTorque.data(); }
+    const double* linearSpeedData() const { return linearSpeed.data(); }
+
+    // "avx512", "avx2" or "scalar"
+    static const char* kernelName();
+
+    double wheelRadius;   // wheel radius (meters)
+    double mass;          // vehicle mass (kg)
+    double wheelInertia;  // moment of inertia per wheel (kg·m^2)
+    double frictionShape; // k in mu = muPeak * (1 - exp(-k |slip|))
+
+private:
+    int numVehicles;
+    int numWheels;
+
+    std::vector<double> angularVelocity;
+    std::vector<double> brakeTorque;
+    std::vector<double> driveTorque;
+    std::vector<double> rotationAngle;
+    std::vector<double> muPeak;          // per wheel, so split-mu roads fit too
+    std::vector<double> linearSpeed;     // per vehicle
+
+    // Scratch: vehicle speed broadcast to each wheel, signed friction force
+    std::vector<double> wheelVehicleSpeed;
+    std::vector<double> frictionForce;
+
+    std::shared_ptr<const FrictionTable> tireTable;
+
+    void broadcastSpeed();
+    void frictionKernel(std::size_t begin, std::size_t end);
+    void wheelKernel(std::size_t begin, std::size_t end, double dt);
+    void tableFrictionKernel();
+    void tableWheelKernel(double dt);
+};
@@ -1,21 +1,116 @@
 #pragma once
 
 #include <SDL2/SDL.h>
+#include <memory>
+#include <vector>
 #include "Vehicle.h"
+#include "FrameRecorder.h"
+#include "FlightRecorder.h"
+#include "SpscRing.h"
+#include "StripChart.h"
+
+struct VisualizerOptions {
+    // With vsync, presenting a frame waits for the display refresh, which
+    // paces the render loop; without it (or if the driver refuses) the
+    // caller has to pace itself, see hasVsync()
+    bool vsync = true;
+    // Software rendering into an in-memory surface: no window, and no
+    // display or video driver needed (CI, render farms)
+    bool offscreen = false;
+    int  width  = 800;
+    int  height = 600;
+    // Strip charts of the last 60 s of the first vehicle (slip, torques,
+    // speeds per wheel) below the vehicle tiles; fed by pushTelemetry()
+    bool charts = false;
+};
 
 class Visualizer {
 public:
-    Visualizer();
+    explicit Visualizer(const VisualizerOptions& options = VisualizerOptions());
     ~Visualizer();
 
-    bool isRunning() const;
-    void render(const Vehicle& vehicle);
+    // Handles window events; false once the window was closed (never for
+    // an offscreen visualizer)
+    bool isRunning();
+
+    // Draws one vehicle, or several side by side in a grid of tiles. Returns
+    // false if the frame was skipped (see setFrameSkip) and nothing was
+    // presented.
+    bool render(const Vehicle& vehicle);
+    bool render(const std::vector<Vehicle>& vehicles);
+
+    bool hasVsync() const { return vsync; }
+    bool isOffscreen() const { return surface != nullptr; }
+
+    // Size in pixels of what render() draws
+    void getOutputSize(int& width, int& height) const;
+
+    // Every presented frame is also read back and handed to the recorder
+    // (cropped or padded if the window was resized); nullptr stops recording
+    void setRecorder(std::shared_ptr<FrameRecorder> frameRecorder) { recorder = std::move(frameRecorder); }
+
+    // Producer side (one thread, e.g. the physics thread): the state of the
+    // first vehicle after a step. False if charts are off or the queue is
+    // full; the charts then show a gap.
+    bool pushTelemetry(const TelemetryRecord& record) { return telemetry && telemetry->push(record); }
+    bool hasCharts() const { return telemetry != nullptr; }
+
+    // Draw only one of every (frames + 1) render() calls
+    void setFrameSkip(int frames) { frameSkip = frames > 0 ? frames : 0; }
+
+    // True once after P was pressed (print the latency report)
+    bool takeReportRequest()
+    {
+        bool requested = reportRequested;
+        reportRequested = false;
+        return requested;
+    }
 
 private:
+    // Textured quad: a source rectangle of a texture drawn to dst
+    struct Sprite {
+        SDL_Rect src;
+        SDL_Rect dst;
+    };
+
     SDL_Window* window;
     SDL_Renderer* renderer;
+    SDL_Surface* surface = nullptr;  // render target when offscreen
+    std::shared_ptr<FrameRecorder> recorder;
+    SDL_Texture* carTexture = nullptr;    // car body, drawn once at startup
+    SDL_Texture* wheelTexture = nullptr;  // tire with tread grooves, scrolled as it turns
+    bool vsync = false;
+    int frameSkip = 0;
+    long long frameCounter = 0;
+    bool reportRequested = false;
+
+    // One batch per color or texture, refilled every frame (the storage is reused)
+    std::vector<SDL_Rect> speedBars;
+    std::vector<SDL_Rect> wheelSpeedBars;
+    std::vector<SDL_Rect> slipBars;
+    std::vector<Sprite> cars;
+    std::vector<Sprite> wheels;
+    // Physics thread -> renderer, drained every render() call
+    std::unique_ptr<SpscRing<TelemetryRecord>> telemetry;
+    std::vector<TelemetryRecord> telemetryBatch;
+    std::unique_ptr<StripChart> slipChart;
+    std::unique_ptr<StripChart> torqueChart;
+    std::unique_ptr<StripChart> speedChart;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+#endif
+
+    bool renderAll(const Vehicle* vehicles, int count);
+    void createTextures();
+    void captureFrame(int outW, int outH);
+    void updateCharts(const Vehicle& charted);
+    void drawCharts(const SDL_Rect& area);
 
-    void drawCarAndWheels(const Vehicle& vehicle);
+    // Queue a vehicle's car, wheels and bars, laid out in `tile`
+    void addCarAndWheels(const Vehicle& vehicle, const SDL_Rect& tile);
+    void addBarGraphs(const Vehicle& vehicle, const SDL_Rect& tile);
 
-    void drawBarGraphs(const Vehicle& vehicle);
+    void fillRects(const std::vector<SDL_Rect>& rects, Uint8 r, Uint8 g, Uint8 b);
+    void drawSprites(SDL_Texture* texture, const std::vector<Sprite>& sprites);
 };
@@ -0,0 +1,253 @@
+#include "BatchSimulation.h"
+#include "FixedTractionControl.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <type_traits>
+
+namespace {
+
+// SplitMix64 finalizer: turns (seed, index) into well-separated stream seeds.
+std::uint64_t mix64(std::uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Scenarios handed to a worker at a time; large enough to keep the shared
+// counter off the hot path, small enough to balance uneven step counts.
+const std::size_t kChunkSize = 16;
+
+// A braking vehicle counts as stopped below this fraction of its initial speed
+const double kStopFraction = 0.1;
+
+const SurfaceProfile kNoSurface;
+
+// Works with Vehicle/TractionControl and FixedVehicle<N>/FixedTractionControl<N>
+template <typename VehicleT, typename ControllerT>
+ScenarioResult rollout(VehicleT& vehicle, ControllerT& tc, const Scenario& scenario,
+                       std::uint64_t streamSeed, double dt,
+                       std::shared_ptr<const FrictionTable> tireTable,
+                       const SimulationSnapshot* start)
+{
+    vehicle.setFriction(scenario.friction);
+    vehicle.setTireModel(std::move(tireTable));
+    if constexpr (std::is_same_v<VehicleT, Vehicle>) {
+        vehicle.setIntegrator(scenario.integrator, scenario.integratorTolerance);
+    }
+    if (start) {
+        vehicle.restoreState(start->linearSpeed, start->wheels, (int)start->numWheels);
+    }
+
+    std::mt19937_64 rng(streamSeed);
+    std::normal_distribution<double> noise(0.0, scenario.frictionNoise > 0.0 ? scenario.frictionNoise : 1.0);
+
+    const SurfaceProfile* surface = scenario.surface.get();
+    SurfaceProfile::Cursor cursor(surface ? *surface : kNoSurface);
+    const int lanes = surface ? surface->getNumLanes() : 1;
+
+    ScenarioResult result{};
+    double slipErrorSum = 0.0;
+    long   slipSamples  = 0;
+    bool   stopped      = false;
+    const double stopSpeed = kStopFraction * scenario.initialSpeed;
+
+    for (int step = 0; step < scenario.steps; step++) {
+        double jitter = (scenario.frictionNoise > 0.0) ? noise(rng) : 0.0;
+        if (surface) {
+            cursor.seek(result.distance);
+            for (int i = 0; i < scenario.numWheels; i++) {
+                double mu = scenario.friction * cursor.mu(SurfaceProfile::laneOf(i, lanes));
+                vehicle.setWheelFriction(i, std::max(0.0, mu + jitter));
+            }
+        } else if (scenario.frictionNoise > 0.0) {
+            vehicle.setFriction(std::max(0.0, scenario.friction + jitter));
+        }
+
+        tc.update(vehicle, dt);
+
+        for (int i = 0; i < scenario.numWheels; i++) {
+            double slip = vehicle.computeSlipRatio(i);
+            slipErrorSum     += std::fabs(slip - scenario.desiredSlip);
+            result.maxAbsSlip = std::max(result.maxAbsSlip, std::fabs(slip));
+            slipSamples++;
+        }
+
+        vehicle.update(dt);
+        result.distance += vehicle.getLinearSpeed() * dt;
+        if (!stopped && vehicle.getLinearSpeed() < stopSpeed) {
+            stopped = true;
+            result.stoppingDistance = result.distance;
+        }
+    }
+
+    if (!stopped) {
+        result.stoppingDistance = result.distance;
+    }
+    result.finalSpeed    = vehicle.getLinearSpeed();
+    result.meanSlipError = (slipSamples > 0) ? slipErrorSum / slipSamples : 0.0;
+    return result;
+}
+
+template <int N>
+ScenarioResult fixedRollout(const Scenario& scenario, std::uint64_t streamSeed, double dt,
+                            std::shared_ptr<const FrictionTable> tireTable,
+                            const SimulationSnapshot* start)
+{
+    FixedVehicle<N> vehicle(scenario.initialSpeed);
+    FixedTractionControl<N> tc(scenario.desiredSlip, scenario.gains);
+    return rollout(vehicle, tc, scenario, streamSeed, dt, std::move(tireTable), start);
+}
+
+// FixedVehicle only models the default vehicle parameters
+bool hasDefaultParameters(const SimulationSnapshot& s)
+{
+    return s.wheelRadius  == FixedVehicle<4>::kWheelRadius &&
+           s.mass         == FixedVehicle<4>::kMass &&
+           s.wheelInertia == FixedVehicle<4>::kWheelInertia;
+}
+
+// FixedVehicle only integrates with fixed-step explicit Euler
+bool fixedIntegrator(const Scenario& s)
+{
+    return s.integrator == Vehicle::Integrator::Euler && s.integratorTolerance <= 0.0;
+}
+
+} // namespace
+
+BatchSimulation::BatchSimulation(int numThreads_, std::uint64_t seed_, double physicsDt_)
+    : numThreads(numThreads_),
+      seed(seed_),
+      physicsDt(physicsDt_)
+{
+    if (numThreads <= 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+std::uint64_t BatchSimulation::streamSeed(std::size_t index) const
+{
+    return mix64(seed ^ mix64(static_cast<std::uint64_t>(index)));
+}
+
+std::vector<ScenarioResult> BatchSimulation::run(const std::vector<Scenario>& scenarios)
+{
+    return runAll(scenarios, nullptr);
+}
+
+std::vector<ScenarioResult> BatchSimulation::run(const std::vector<Scenario>& scenarios,
+                                                 const SnapshotArena& starts)
+{
+    if (starts.size() != scenarios.size()) {
+        std::cerr << "Got " << starts.size() << " snapshots for " << scenarios.size()
+                  << " scenarios" << std::endl;
+        return {};
+    }
+    return runAll(scenarios, &starts);
+}
+
+std::vector<ScenarioResult> BatchSimulation::runAll(const std::vector<Scenario>& scenarios,
+                                                    const SnapshotArena* starts)
+{
+    using clock = std::chrono::steady_clock;
+
+    std::vector<ScenarioResult> results(scenarios.size());
+    std::atomic<std::size_t> next{0};
+
+    auto worker = [&]() {
+        for (;;) {
+            std::size_t begin = next.fetch_add(kChunkSize, std::memory_order_relaxed);
+            if (begin >= scenarios.size()) break;
+            std::size_t end = std::min(begin + kChunkSize, scenarios.size());
+            for (std::size_t i = begin; i < end; i++) {
+                results[i] = runScenario(scenarios[i], streamSeed(i), physicsDt, tireTable,
+                                         starts ? &(*starts)[i] : nullptr);
+            }
+        }
+    };
+
+    auto start = clock::now();
+
+    int threadCount = (int)std::min<std::size_t>(numThreads,
+                          (scenarios.size() + kChunkSize - 1) / kChunkSize);
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threadCount; t++) {
+        pool.emplace_back(worker);
+    }
+    worker(); // the calling thread takes part as well
+    for (auto& th : pool) {
+        th.join();
+    }
+
+    double seconds = std::chrono::duration<double>(clock::now() - start).count();
+
+    stats.scenarios = scenarios.size();
+    stats.threads   = std::max(threadCount, 1);
+    stats.seconds   = seconds;
+    stats.scenariosPerSecond = (seconds > 0.0) ? scenarios.size() / seconds : 0.0;
+
+    return results;
+}
+
+ScenarioResult BatchSimulation::runScenario(const Scenario& scenario, std::uint64_t streamSeed, double dt,
+                                            std::shared_ptr<const FrictionTable> tireTable,
+                                            const SimulationSnapshot* start)
+{
+    // A branch continues from the snapshot; the scenario only contributes the road
+    Scenario branch = scenario;
+    if (start) {
+        branch.initialSpeed = start->linearSpeed;
+        branch.desiredSlip  = start->desiredSlip;
+        branch.gains        = start->gains;
+        branch.numWheels    = (int)start->numWheels;
+        if (!hasDefaultParameters(*start) || !fixedIntegrator(branch)) {
+            Vehicle vehicle = restoreVehicle(*start);
+            TractionControl tc = restoreController(*start);
+            return rollout(vehicle, tc, branch, streamSeed, dt, std::move(tireTable), nullptr);
+        }
+    }
+
+    // Common wheel counts use the compile-time specialized vehicle; the
+    // results are identical, only faster. It only implements plain Euler.
+    switch (fixedIntegrator(branch) ? branch.numWheels : 0) {
+        case 2: return fixedRollout<2>(branch, streamSeed, dt, tireTable, start);
+        case 4: return fixedRollout<4>(branch, streamSeed, dt, tireTable, start);
+        case 6: return fixedRollout<6>(branch, streamSeed, dt, tireTable, start);
+        case 8: return fixedRollout<8>(branch, streamSeed, dt, tireTable, start);
+        default: break;
+    }
+
+    Vehicle vehicle(branch.initialSpeed, branch.numWheels);
+    TractionControl tc(branch.desiredSlip, branch.gains);
+    return rollout(vehicle, tc, branch, streamSeed, dt, std::move(tireTable), start);
+}
+
+std::vector<Scenario> BatchSimulation::makeGrid(const std::vector<double>& frictions,
+                                                const std::vector<double>& speeds,
+                                                const std::vector<double>& desiredSlips,
+                                                int steps, int numWheels)
+{
+    std::vector<Scenario> grid;
+    grid.reserve(frictions.size() * speeds.size() * desiredSlips.size());
+
+    for (double mu : frictions) {
+        for (double v : speeds) {
+            for (double slip : desiredSlips) {
+                Scenario s;
+                s.friction     = mu;
+                s.initialSpeed = v;
+                s.desiredSlip  = slip;
+                s.steps        = steps;
+                s.numWheels    = numWheels;
+                grid.push_back(s);
+            }
+        }
+    }
+    return grid;
+}
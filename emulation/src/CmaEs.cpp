@@ -0,0 +1,184 @@
+#include "CmaEs.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+using Matrix = std::vector<std::vector<double>>;
+
+// Cyclic Jacobi rotations: A = V diag(eigenvalues) V^T for symmetric A.
+// Plenty for the handful of dimensions the tuner uses.
+void symmetricEigen(Matrix A, Matrix& V, std::vector<double>& eigenvalues)
+{
+    const int n = (int)A.size();
+    V.assign(n, std::vector<double>(n, 0.0));
+    for (int i = 0; i < n; i++) V[i][i] = 1.0;
+
+    for (int sweep = 0; sweep < 50; sweep++) {
+        double off = 0.0;
+        for (int p = 0; p < n; p++) {
+            for (int q = p + 1; q < n; q++) off += A[p][q] * A[p][q];
+        }
+        if (off < 1e-30) break;
+
+        for (int p = 0; p < n; p++) {
+            for (int q = p + 1; q < n; q++) {
+                if (A[p][q] == 0.0) continue;
+                double theta = (A[q][q] - A[p][p]) / (2.0 * A[p][q]);
+                double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+                double c = 1.0 / std::sqrt(t * t + 1.0);
+                double s = t * c;
+
+                for (int k = 0; k < n; k++) {
+                    double akp = A[k][p], akq = A[k][q];
+                    A[k][p] = c * akp - s * akq;
+                    A[k][q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < n; k++) {
+                    double apk = A[p][k], aqk = A[q][k];
+                    A[p][k] = c * apk - s * aqk;
+                    A[q][k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < n; k++) {
+                    double vkp = V[k][p], vkq = V[k][q];
+                    V[k][p] = c * vkp - s * vkq;
+                    V[k][q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+
+    eigenvalues.resize(n);
+    for (int i = 0; i < n; i++) eigenvalues[i] = A[i][i];
+}
+
+} // namespace
+
+CmaEs::CmaEs(const std::vector<double>& mean_, double sigma_, int population, std::uint64_t seed)
+    : n((int)mean_.size()),
+      mean(mean_),
+      sigma(sigma_),
+      rng(seed)
+{
+    lambda = population > 0 ? population : 4 + (int)(3.0 * std::log((double)n));
+    lambda = std::max(lambda, 2);
+    mu = lambda / 2;
+
+    // Log-rank recombination weights
+    weights.resize(mu);
+    for (int i = 0; i < mu; i++) {
+        weights[i] = std::log(mu + 0.5) - std::log(i + 1.0);
+    }
+    double sum = std::accumulate(weights.begin(), weights.end(), 0.0);
+    double sumSq = 0.0;
+    for (auto& w : weights) {
+        w /= sum;
+        sumSq += w * w;
+    }
+    muEff = 1.0 / sumSq;
+
+    cc    = (4.0 + muEff / n) / (n + 4.0 + 2.0 * muEff / n);
+    cs    = (muEff + 2.0) / (n + muEff + 5.0);
+    c1    = 2.0 / ((n + 1.3) * (n + 1.3) + muEff);
+    cmu   = std::min(1.0 - c1, 2.0 * (muEff - 2.0 + 1.0 / muEff) / ((n + 2.0) * (n + 2.0) + muEff));
+    damps = 1.0 + 2.0 * std::max(0.0, std::sqrt((muEff - 1.0) / (n + 1.0)) - 1.0) + cs;
+    chiN  = std::sqrt((double)n) * (1.0 - 1.0 / (4.0 * n) + 1.0 / (21.0 * n * n));
+
+    pc.assign(n, 0.0);
+    ps.assign(n, 0.0);
+    C.assign(n, std::vector<double>(n, 0.0));
+    for (int i = 0; i < n; i++) C[i][i] = 1.0;
+    decompose();
+}
+
+void CmaEs::decompose()
+{
+    std::vector<double> eigenvalues;
+    symmetricEigen(C, B, eigenvalues);
+    D.resize(n);
+    for (int i = 0; i < n; i++) {
+        D[i] = std::sqrt(std::max(eigenvalues[i], 1e-20));
+    }
+}
+
+std::vector<std::vector<double>> CmaEs::ask()
+{
+    std::vector<std::vector<double>> candidates(lambda, std::vector<double>(n));
+    std::vector<double> z(n);
+
+    for (auto& x : candidates) {
+        // x = mean + sigma * B * D * z,  z ~ N(0, I)
+        for (int i = 0; i < n; i++) {
+            z[i] = D[i] * normal(rng);
+        }
+        for (int i = 0; i < n; i++) {
+            double y = 0.0;
+            for (int j = 0; j < n; j++) y += B[i][j] * z[j];
+            x[i] = mean[i] + sigma * y;
+        }
+    }
+    return candidates;
+}
+
+void CmaEs::tell(const std::vector<std::vector<double>>& candidates, const std::vector<double>& fitness)
+{
+    std::vector<int> order(candidates.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return fitness[a] < fitness[b]; });
+
+    // New mean from the mu best candidates
+    std::vector<double> old = mean;
+    for (int i = 0; i < n; i++) {
+        mean[i] = 0.0;
+        for (int k = 0; k < mu; k++) {
+            mean[i] += weights[k] * candidates[order[k]][i];
+        }
+    }
+
+    std::vector<double> step(n);
+    for (int i = 0; i < n; i++) {
+        step[i] = (mean[i] - old[i]) / sigma;
+    }
+
+    // ps uses C^-1/2 * step = B * D^-1 * B^T * step
+    std::vector<double> tmp(n, 0.0);
+    for (int j = 0; j < n; j++) {
+        for (int i = 0; i < n; i++) tmp[j] += B[i][j] * step[i];
+        tmp[j] /= D[j];
+    }
+    double psNorm = 0.0;
+    for (int i = 0; i < n; i++) {
+        double y = 0.0;
+        for (int j = 0; j < n; j++) y += B[i][j] * tmp[j];
+        ps[i] = (1.0 - cs) * ps[i] + std::sqrt(cs * (2.0 - cs) * muEff) * y;
+        psNorm += ps[i] * ps[i];
+    }
+    psNorm = std::sqrt(psNorm);
+
+    generation++;
+    bool hsig = psNorm / std::sqrt(1.0 - std::pow(1.0 - cs, 2.0 * generation)) / chiN
+                < 1.4 + 2.0 / (n + 1.0);
+
+    for (int i = 0; i < n; i++) {
+        pc[i] = (1.0 - cc) * pc[i] + (hsig ? std::sqrt(cc * (2.0 - cc) * muEff) * step[i] : 0.0);
+    }
+
+    // Rank-one and rank-mu covariance update
+    double keep = 1.0 - c1 - cmu + (hsig ? 0.0 : c1 * cc * (2.0 - cc));
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j <= i; j++) {
+            double rankMu = 0.0;
+            for (int k = 0; k < mu; k++) {
+                const auto& x = candidates[order[k]];
+                rankMu += weights[k] * (x[i] - old[i]) * (x[j] - old[j]);
+            }
+            rankMu /= sigma * sigma;
+            C[i][j] = keep * C[i][j] + c1 * pc[i] * pc[j] + cmu * rankMu;
+            C[j][i] = C[i][j];
+        }
+    }
+
+    sigma *= std::exp((cs / damps) * (psNorm / chiN - 1.0));
+    decompose();
+}
@@ -0,0 +1,98 @@
+#include "ColumnarDataset.h"
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+uint32_t readU32(const unsigned char* p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+uint64_t readU64(const unsigned char* p)
+{
+    return readU32(p) | ((uint64_t)readU32(p + 4) << 32);
+}
+
+float readF32(const unsigned char* p)
+{
+    uint32_t bits = readU32(p);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+bool ColumnarDataset::open(const std::string& path)
+{
+    close();
+    if (!file.open(path)) return false;
+
+    const unsigned char* base = file.getData();
+    std::size_t size = file.getSize();
+
+    if (size < dataset::kHeaderBytes || std::memcmp(base, dataset::kMagic, 4) != 0) {
+        std::cerr << "Not a columnar dataset: " << path << std::endl;
+        close();
+        return false;
+    }
+    if (readU32(base + 4) != dataset::kVersion) {
+        std::cerr << "Unsupported dataset version " << readU32(base + 4) << ": " << path << std::endl;
+        close();
+        return false;
+    }
+
+    uint32_t numColumns = readU32(base + 8);
+    chunkRows = readU32(base + 12);
+    numRows   = (std::size_t)readU64(base + 16);
+    uint64_t dataOffset = readU64(base + 24);
+
+    std::size_t chunkBytes = (std::size_t)numColumns * chunkRows * sizeof(float);
+    numChunks = (chunkRows > 0) ? (numRows + chunkRows - 1) / chunkRows : 0;
+
+    if (numColumns == 0 || chunkRows == 0 ||
+        dataset::kHeaderBytes + numColumns * dataset::kColumnBytes > dataOffset ||
+        dataOffset % dataset::kAlignment != 0 ||
+        dataOffset + numChunks * chunkBytes > size) {
+        std::cerr << "Corrupt or truncated dataset: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    for (uint32_t c = 0; c < numColumns; c++) {
+        const unsigned char* desc = base + dataset::kHeaderBytes + c * dataset::kColumnBytes;
+        dataset::ColumnInfo info;
+        info.name = std::string(reinterpret_cast<const char*>(desc),
+                                strnlen(reinterpret_cast<const char*>(desc), dataset::kNameBytes));
+        info.min  = readF32(desc + dataset::kNameBytes);
+        info.max  = readF32(desc + dataset::kNameBytes + 4);
+        columns.push_back(info);
+    }
+
+    // Page-aligned offset, so the float payload is suitably aligned
+    data = reinterpret_cast<const float*>(base + dataOffset);
+    return true;
+}
+
+void ColumnarDataset::close()
+{
+    file.close();
+    data = nullptr;
+    numRows = numChunks = chunkRows = 0;
+    columns.clear();
+}
+
+int ColumnarDataset::columnIndex(const std::string& name) const
+{
+    for (std::size_t c = 0; c < columns.size(); c++) {
+        if (columns[c].name == name) return (int)c;
+    }
+    return -1;
+}
+
+std::size_t ColumnarDataset::rowsInChunk(std::size_t chunk) const
+{
+    if (chunk + 1 < numChunks) return chunkRows;
+    return numRows - chunk * chunkRows;
+}
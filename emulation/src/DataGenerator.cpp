@@ -0,0 +1,205 @@
+#include "DataGenerator.h"
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Philox.h"
+#include "SurfaceProfile.h"
+#include "Vehicle.h"
+#include "TractionControl.h"
+
+namespace {
+
+const int    kNumWheels = 4;
+const double kPhysicsDt = 0.01;  // Fixed time step for consistency
+
+// Scenarios per shard: the unit of work handed to a worker
+const std::size_t kShardScenarios = 16;
+
+enum class Road { Uniform, IcePatch, WetTransition, SplitMu };
+
+struct ScenarioParams {
+    double mu;           // road friction
+    Road   road;         // what the road does along the track
+    double lowMu;        // friction of the ice / wet / low side section
+    double roadStart;    // meters to the section
+    double roadLength;   // meters the section lasts
+    double speed;        // initial speed
+    double desiredSlip;  // desired slip ratio
+    int    steps;        // number of simulation steps
+    long long rows;      // rows this scenario contributes (the last one may be cut short)
+};
+
+// Randomized parameters of scenario `index`, from its own Philox stream
+ScenarioParams drawScenario(std::uint64_t seed, std::uint64_t index)
+{
+    PhiloxStream rng(seed, index);
+    ScenarioParams p;
+    p.mu          = rng.uniform(0.5, 1.0);
+    p.speed       = rng.uniform(5.0, 25.0);
+    p.desiredSlip = rng.uniform(0.05, 0.15);
+    p.steps       = rng.uniformInt(500, 1500);
+    p.rows        = (long long)p.steps * kNumWheels;
+    p.road        = (Road)rng.uniformInt(0, 3);
+    p.lowMu       = rng.uniform(0.1, 0.5);
+    p.roadStart   = rng.uniform(0.0, 100.0);
+    p.roadLength  = rng.uniform(5.0, 50.0);
+    return p;
+}
+
+SurfaceProfile makeRoad(const ScenarioParams& p)
+{
+    switch (p.road) {
+        case Road::IcePatch:      return SurfaceProfile::icePatch(p.mu, p.lowMu, p.roadStart, p.roadLength);
+        case Road::WetTransition: return SurfaceProfile::wetTransition(p.mu, p.lowMu, p.roadStart, p.roadLength);
+        case Road::SplitMu:       return SurfaceProfile::splitMu(p.mu, p.mu, p.lowMu, p.roadStart, p.roadLength);
+        default:                  return SurfaceProfile::uniform(p.mu);
+    }
+}
+
+// Simulates one scenario and passes its first p.rows records to emit
+template <typename Emit>
+void simulateScenario(const ScenarioParams& p, Emit&& emit)
+{
+    Vehicle vehicle(p.speed, kNumWheels);
+    TractionControl tc(p.desiredSlip);
+    const double desiredSlip = p.desiredSlip;
+    const double physicsDt = kPhysicsDt;
+    long long rows = 0;
+
+    const SurfaceProfile road = makeRoad(p);
+    SurfaceProfile::Cursor cursor(road);
+    double distance = 0.0;
+
+    for (int step = 0; step < p.steps && rows < p.rows; ++step) {
+        // Road friction under each wheel at the current position
+        cursor.seek(distance);
+        for (int i = 0; i < kNumWheels; i++) {
+            vehicle.setWheelFriction(i, cursor.mu(SurfaceProfile::laneOf(i, road.getNumLanes())));
+        }
+
+        tc.update(vehicle, physicsDt); // Update vehicle state
+
+        // Log data
+        const auto& wheels = vehicle.getWheels();
+        for (size_t i = 0; i < wheels.size(); ++i) {
+            double slip = vehicle.computeSlipRatio(i);
+            const auto& wheel = wheels[i];
+
+            // Compute desired torques based on the current state
+            double desiredBrakeTorque = 0.0;
+            double desiredDriveTorque = 0.0;
+
+            if (slip > desiredSlip) {
+                // Too much slip => ramp up brake, reduce drive
+                desiredBrakeTorque = std::min(200.0, wheel.brakeTorque + (500.0 * (slip - desiredSlip) * physicsDt));
+                desiredDriveTorque = std::max(0.0, wheel.driveTorque - (300.0 * (slip - desiredSlip) * physicsDt));
+            } else {
+                // Too little slip => reduce brake, ramp up drive
+                double slipDiff = desiredSlip - slip;
+                desiredBrakeTorque = std::max(0.0, wheel.brakeTorque - (500.0 * slipDiff * physicsDt));
+                desiredDriveTorque = std::min(150.0, wheel.driveTorque + (300.0 * slipDiff * physicsDt));
+            }
+
+            emit(TraceRecord{(int)i, slip, wheel.angularVelocity, vehicle.getLinearSpeed(),
+                             wheel.brakeTorque, wheel.driveTorque,
+                             desiredBrakeTorque, desiredDriveTorque});
+            rows++;
+            if (rows >= p.rows) break;
+        }
+
+        // Update vehicle physics
+        vehicle.update(physicsDt);
+        distance += vehicle.getLinearSpeed() * physicsDt;
+    }
+}
+
+} // namespace
+
+long long generateData(TraceWriter& writer, long long numEntries, std::uint64_t seed, int numThreads)
+{
+    // Plan every scenario up front; row counts follow from the parameters
+    std::vector<ScenarioParams> plan;
+    long long entriesGenerated = 0;
+    while (entriesGenerated < numEntries) {
+        ScenarioParams p = drawScenario(seed, plan.size());
+        p.rows = std::min(p.rows, numEntries - entriesGenerated);
+        entriesGenerated += p.rows;
+        plan.push_back(p);
+    }
+
+    if (numThreads <= 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const std::size_t numShards = (plan.size() + kShardScenarios - 1) / kShardScenarios;
+
+    auto push = [&](const TraceRecord& record) { writer.push(record); };
+    if (numThreads == 1 || numShards <= 1) {
+        for (const auto& p : plan) {
+            simulateScenario(p, push);
+        }
+        return entriesGenerated;
+    }
+
+    // Workers fill shard buffers; this thread hands them to the writer in
+    // order. At most `window` shards are in flight to bound memory.
+    const std::size_t window = 2 * (std::size_t)numThreads;
+    std::vector<std::vector<TraceRecord>> slots(window);
+    std::vector<bool> ready(window, false);
+    std::size_t nextShard = 0;
+    std::size_t emitted   = 0;
+    std::mutex mutex;
+    std::condition_variable changed;
+
+    auto worker = [&]() {
+        for (;;) {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&] { return nextShard >= numShards || nextShard < emitted + window; });
+            if (nextShard >= numShards) return;
+            std::size_t shard = nextShard++;
+            lock.unlock();
+
+            std::size_t begin = shard * kShardScenarios;
+            std::size_t end   = std::min(begin + kShardScenarios, plan.size());
+            std::vector<TraceRecord> records;
+            long long rows = 0;
+            for (std::size_t s = begin; s < end; s++) rows += plan[s].rows;
+            records.reserve(rows);
+            for (std::size_t s = begin; s < end; s++) {
+                simulateScenario(plan[s], [&](const TraceRecord& record) { records.push_back(record); });
+            }
+
+            lock.lock();
+            slots[shard % window] = std::move(records);
+            ready[shard % window] = true;
+            changed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 0; t < numThreads; t++) {
+        pool.emplace_back(worker);
+    }
+
+    for (std::size_t shard = 0; shard < numShards; shard++) {
+        std::vector<TraceRecord> records;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&] { return ready[shard % window]; });
+            records.swap(slots[shard % window]);
+            ready[shard % window] = false;
+            emitted = shard + 1;
+        }
+        changed.notify_all();
+
+        for (const auto& record : records) {
+            writer.push(record);
+        }
+    }
+
+    for (auto& th : pool) {
+        th.join();
+    }
+    return entriesGenerated;
+}
@@ -0,0 +1,106 @@
+#include "FixedStepLoop.h"
+#include <algorithm>
+
+FixedStepLoop::FixedStepLoop(double stepSeconds_, int maxCatchUpSteps_, double timeScale_)
+    : stepSeconds(stepSeconds_),
+      maxCatchUpSteps(std::max(maxCatchUpSteps_, 0)),
+      timeScale(timeScale_)
+{
+    if (timeScale > 0.0) {
+        period = std::chrono::duration_cast<clock::duration>(
+            std::chrono::duration<double>(stepSeconds / timeScale));
+    }
+}
+
+FixedStepLoop::~FixedStepLoop()
+{
+    stop();
+}
+
+void FixedStepLoop::start(std::function<bool()> step_)
+{
+    if (worker.joinable()) return;
+
+    step = std::move(step_);
+    stopRequested = false;
+    finished = false;
+    if (period > clock::duration::zero()) {
+        worker = std::thread(&FixedStepLoop::run, this);
+    } else {
+        worker = std::thread(&FixedStepLoop::runUnpaced, this);
+    }
+}
+
+void FixedStepLoop::stop()
+{
+    if (!worker.joinable()) return;
+
+    stopRequested = true;
+    worker.join();
+}
+
+void FixedStepLoop::wait()
+{
+    if (worker.joinable()) worker.join();
+}
+
+StepStats FixedStepLoop::getStats() const
+{
+    StepStats stats;
+    stats.steps           = steps.load(std::memory_order_relaxed);
+    stats.overruns        = overruns.load(std::memory_order_relaxed);
+    stats.droppedSteps    = droppedSteps.load(std::memory_order_relaxed);
+    stats.maxStepSeconds  = maxStepNanos.load(std::memory_order_relaxed) * 1e-9;
+    stats.lastStepSeconds = lastStepNanos.load(std::memory_order_relaxed) * 1e-9;
+    return stats;
+}
+
+bool FixedStepLoop::timedStep()
+{
+    auto begin = clock::now();
+    bool more = step();
+    auto end = clock::now();
+
+    int64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+    lastStepNanos.store(nanos, std::memory_order_relaxed);
+    if (nanos > maxStepNanos.load(std::memory_order_relaxed)) {
+        maxStepNanos.store(nanos, std::memory_order_relaxed);
+    }
+    steps.fetch_add(1, std::memory_order_relaxed);
+
+    if (!more) {
+        finished.store(true, std::memory_order_release);
+    }
+    return more;
+}
+
+void FixedStepLoop::run()
+{
+    auto deadline = clock::now() + period;
+
+    while (!stopRequested.load(std::memory_order_relaxed)) {
+        if (!timedStep()) break;
+
+        auto end = clock::now();
+        if (end > deadline) {
+            overruns.fetch_add(1, std::memory_order_relaxed);
+
+            // Whole periods we are behind; catch up only a bounded amount
+            auto behind = (end - deadline) / period;
+            if (behind > maxCatchUpSteps) {
+                droppedSteps.fetch_add(behind, std::memory_order_relaxed);
+                deadline = end;
+            }
+        } else {
+            std::this_thread::sleep_until(deadline);
+        }
+        deadline += period;
+    }
+}
+
+void FixedStepLoop::runUnpaced()
+{
+    while (!stopRequested.load(std::memory_order_relaxed)) {
+        if (!timedStep()) break;
+    }
+}
@@ -0,0 +1,111 @@
+#include "FleetTractionControl.h"
+#include <algorithm>
+#include <iostream>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const double kMinSpeed = 0.001;   // same denominator guard as Vehicle::computeSlipRatio
+
+} // namespace
+
+FleetTractionControl::FleetTractionControl(int numVehicles, int numWheels_, double desiredSlip_,
+                                           const TractionGains& gains_)
+    : numWheels(numWheels_),
+      gains(gains_)
+{
+    desiredSlip.assign((std::size_t)numVehicles * numWheels, desiredSlip_);
+    slip.assign(desiredSlip.size(), 0.0);
+}
+
+void FleetTractionControl::setDesiredSlip(int v, double value)
+{
+    std::fill_n(desiredSlip.begin() + (std::size_t)v * numWheels, numWheels, value);
+}
+
+void FleetTractionControl::update(VehicleFleet& fleet, double dt)
+{
+    const int numVehicles = fleet.getNumVehicles();
+    if (fleet.getNumWheels() != numWheels || (std::size_t)numVehicles * numWheels != slip.size()) {
+        std::cerr << "FleetTractionControl sized for " << slip.size() / std::max(numWheels, 1) << "x"
+                  << numWheels << " wheels, fleet has " << numVehicles << "x" << fleet.getNumWheels()
+                  << std::endl;
+        return;
+    }
+    const double r = fleet.wheelRadius;
+    const double* omega = fleet.angularVelocityData();
+    const double* speed = fleet.linearSpeedData();
+
+    // Slip of every wheel, as in Vehicle::computeSlipRatio
+    for (int v = 0; v < numVehicles; v++) {
+        double denom = std::max(speed[v], kMinSpeed);
+        for (int w = 0; w < numWheels; w++) {
+            std::size_t i = fleet.index(v, w);
+            slip[i] = (omega[i] * r - speed[v]) / denom;
+        }
+    }
+
+    // Slip error e > 0: brake = min(maxB, b + kB e dt), drive = max(0, d - kD e dt)
+    // otherwise:        brake = b + kB e dt,            drive = min(maxD, d - kD e dt)
+    // and both are clamped at 0 like Vehicle::set*Torque. The min/max operand
+    // order matches std::min/std::max, so NaN slips end up as they would there.
+    const std::size_t n = slip.size();
+    const double* s   = slip.data();
+    const double* ref = desiredSlip.data();
+    double* brake = fleet.brakeTorqueData();
+    double* drive = fleet.driveTorqueData();
+    std::size_t i = 0;
+
+#if defined(__AVX512F__)
+    const __m512d kB    = _mm512_set1_pd(gains.brakeRampRate);
+    const __m512d kD    = _mm512_set1_pd(gains.driveRampRate);
+    const __m512d maxB  = _mm512_set1_pd(gains.maxBrakeTorque);
+    const __m512d maxD  = _mm512_set1_pd(gains.maxDriveTorque);
+    const __m512d step  = _mm512_set1_pd(dt);
+    const __m512d zero  = _mm512_setzero_pd();
+    for (; i + 8 <= n; i += 8) {
+        __m512d e = _mm512_sub_pd(_mm512_loadu_pd(s + i), _mm512_loadu_pd(ref + i));
+        __mmask8 over = _mm512_cmp_pd_mask(e, zero, _CMP_GT_OQ);
+
+        __m512d b = _mm512_add_pd(_mm512_loadu_pd(brake + i), _mm512_mul_pd(_mm512_mul_pd(kB, e), step));
+        __m512d d = _mm512_sub_pd(_mm512_loadu_pd(drive + i), _mm512_mul_pd(_mm512_mul_pd(kD, e), step));
+        b = _mm512_mask_min_pd(b, over, b, maxB);
+        d = _mm512_mask_min_pd(_mm512_min_pd(d, maxD), over, d, d);
+
+        _mm512_storeu_pd(brake + i, _mm512_max_pd(b, zero));
+        _mm512_storeu_pd(drive + i, _mm512_max_pd(d, zero));
+    }
+#elif defined(__AVX2__)
+    const __m256d kB    = _mm256_set1_pd(gains.brakeRampRate);
+    const __m256d kD    = _mm256_set1_pd(gains.driveRampRate);
+    const __m256d maxB  = _mm256_set1_pd(gains.maxBrakeTorque);
+    const __m256d maxD  = _mm256_set1_pd(gains.maxDriveTorque);
+    const __m256d step  = _mm256_set1_pd(dt);
+    const __m256d zero  = _mm256_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+        __m256d e = _mm256_sub_pd(_mm256_loadu_pd(s + i), _mm256_loadu_pd(ref + i));
+        __m256d over = _mm256_cmp_pd(e, zero, _CMP_GT_OQ);
+
+        __m256d b = _mm256_add_pd(_mm256_loadu_pd(brake + i), _mm256_mul_pd(_mm256_mul_pd(kB, e), step));
+        __m256d d = _mm256_sub_pd(_mm256_loadu_pd(drive + i), _mm256_mul_pd(_mm256_mul_pd(kD, e), step));
+        b = _mm256_blendv_pd(b, _mm256_min_pd(b, maxB), over);
+        d = _mm256_blendv_pd(_mm256_min_pd(d, maxD), d, over);
+
+        _mm256_storeu_pd(brake + i, _mm256_max_pd(b, zero));
+        _mm256_storeu_pd(drive + i, _mm256_max_pd(d, zero));
+    }
+#endif
+
+    for (; i < n; i++) {
+        double e = s[i] - ref[i];
+        double b = brake[i] + gains.brakeRampRate * e * dt;
+        double d = drive[i] - gains.driveRampRate * e * dt;
+        b = (e > 0.0) ? std::min(gains.maxBrakeTorque, b) : b;
+        d = (e > 0.0) ? d : std::min(gains.maxDriveTorque, d);
+        brake[i] = std::max(0.0, b);
+        drive[i] = std::max(0.0, d);
+    }
+}
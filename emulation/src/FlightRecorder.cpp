@@ -0,0 +1,263 @@
+#include "FlightRecorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+const char     kMagic[4] = {'T', 'C', 'F', 'R'};
+const uint32_t kVersion  = 1;
+
+// How often the writer wakes up to drain the ring; at 100 Hz and a few
+// vehicles this is far below the default ring capacity. Unpaced runs fill it
+// faster, so after a large batch the writer only yields.
+const auto kDrainPeriod = std::chrono::milliseconds(5);
+const std::size_t kDrainBatch = 256;
+
+struct FileHeader {
+    char     magic[4];
+    uint32_t version;
+    uint32_t recordBytes;
+    uint32_t vehiclesPerStep;
+    uint64_t capacity;
+    uint64_t count;      // records written so far
+    double   physicsDt;
+    uint64_t reserved[3];
+};
+static_assert(sizeof(FileHeader) == 64, "flight recorder header is 64 bytes");
+
+FileHeader makeHeader(uint64_t capacity, uint64_t count, double physicsDt, uint32_t vehiclesPerStep)
+{
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, 4);
+    header.version         = kVersion;
+    header.recordBytes     = sizeof(TelemetryRecord);
+    header.vehiclesPerStep = vehiclesPerStep;
+    header.capacity        = capacity;
+    header.count           = count;
+    header.physicsDt       = physicsDt;
+    return header;
+}
+
+} // namespace
+
+void captureTelemetry(const Vehicle& vehicle, int vehicleIndex, uint64_t step, double time,
+                      TelemetryRecord& r)
+{
+    const auto& wheels = vehicle.getWheels();
+    r.time        = time;
+    r.step        = step;
+    r.vehicle     = (uint16_t)vehicleIndex;
+    r.numWheels   = (uint8_t)std::min<std::size_t>(wheels.size(), TelemetryRecord::kMaxWheels);
+    r.reserved    = 0;
+    r.linearSpeed = (float)vehicle.getLinearSpeed();
+
+    for (int i = 0; i < TelemetryRecord::kMaxWheels; i++) {
+        if (i < r.numWheels) {
+            r.wheelSpeed[i]  = (float)wheels[i].angularVelocity;
+            r.slip[i]        = (float)vehicle.computeSlipRatio(i);
+            r.driveTorque[i] = (float)wheels[i].driveTorque;
+            r.brakeTorque[i] = (float)wheels[i].brakeTorque;
+        } else {
+            r.wheelSpeed[i] = r.slip[i] = r.driveTorque[i] = r.brakeTorque[i] = 0.0f;
+        }
+    }
+}
+
+FlightRecorder::~FlightRecorder()
+{
+    close();
+}
+
+bool FlightRecorder::open(const std::string& path_, double physicsDt, int vehiclesPerStep,
+                          const FlightRecorderOptions& options)
+{
+    close();
+    if (!(physicsDt > 0.0) || vehiclesPerStep <= 0) {
+        std::cerr << "Flight recorder needs a positive time step and vehicle count" << std::endl;
+        return false;
+    }
+
+    auto records = [&](double seconds) {
+        return std::max<uint64_t>(1, (uint64_t)std::llround(std::max(seconds, 0.0) / physicsDt) * vehiclesPerStep);
+    };
+    dumpRecords = records(options.dumpSeconds);
+    capacity    = std::max(records(options.historySeconds), dumpRecords);
+
+    path = path_;
+    if (!file.create(path, sizeof(FileHeader) + capacity * sizeof(TelemetryRecord))) {
+        return false;
+    }
+    FileHeader header = makeHeader(capacity, 0, physicsDt, (uint32_t)vehiclesPerStep);
+    std::memcpy(file.getWritableData(), &header, sizeof(header));
+    slots = reinterpret_cast<TelemetryRecord*>(file.getWritableData() + sizeof(FileHeader));
+
+    ring = std::make_unique<SpscRing<TelemetryRecord>>((std::size_t)std::max(options.queueRecords, 1));
+    slipTrigger = (float)options.slipTrigger;
+    nextDump    = 0;
+    failed      = false;
+    stopping.store(false);
+    dumpEnd.store(0);
+    written.store(0);
+    dropped.store(0);
+    dumps.store(0);
+
+    writer = std::thread(&FlightRecorder::writeLoop, this);
+    return true;
+}
+
+void FlightRecorder::record(const Vehicle& vehicle, int vehicleIndex, uint64_t step, double time)
+{
+    if (!ring) return;
+
+    // Filled in place in the ring, so a record is never copied on this thread
+    TelemetryRecord* slot = ring->claim();
+    if (!slot) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    captureTelemetry(vehicle, vehicleIndex, step, time, *slot);
+    bool slipping = false;
+    for (int i = 0; i < slot->numWheels; i++) {
+        slipping = slipping || std::fabs(slot->slip[i]) > slipTrigger;
+    }
+
+    ring->publish();
+    if (slipping && slipTrigger > 0.0f) {
+        requestDump(ring->published());  // ends with this record
+    }
+}
+
+bool FlightRecorder::close()
+{
+    if (!isOpen()) return !failed;
+
+    stopping.store(true, std::memory_order_release);
+    writer.join();
+
+    file.flush();
+    file.close();
+    slots = nullptr;
+    ring.reset();
+    return !failed;
+}
+
+void FlightRecorder::writeLoop()
+{
+    for (;;) {
+        // Read the flag first, so nothing pushed before close() is missed
+        bool stop = stopping.load(std::memory_order_acquire);
+        // Taken before draining, so the records it covers are written
+        uint64_t end = dumpEnd.exchange(0, std::memory_order_acquire);
+        std::size_t drained = drain();
+        if (end > 0) {
+            end = std::min(end, written.load(std::memory_order_relaxed));
+            if (end >= nextDump) {
+                if (writeDump(end)) {
+                    dumps.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    failed = true;
+                }
+                nextDump = end + dumpRecords;
+            }
+        }
+        if (stop) return;
+        if (drained > ring->capacity() / 4) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(kDrainPeriod);
+        }
+    }
+}
+
+std::size_t FlightRecorder::drain()
+{
+    TelemetryRecord batch[kDrainBatch];
+    const uint64_t start = written.load(std::memory_order_relaxed);
+    uint64_t count = start;
+    std::size_t n;
+    while ((n = ring->pop(batch, kDrainBatch)) > 0) {
+        for (std::size_t i = 0; i < n; i++) {
+            slots[count++ % capacity] = batch[i];
+        }
+    }
+
+    // The count is updated after the records it covers
+    auto* header = reinterpret_cast<FileHeader*>(file.getWritableData());
+    header->count = count;
+    written.store(count, std::memory_order_relaxed);
+    return (std::size_t)(count - start);
+}
+
+bool FlightRecorder::writeDump(uint64_t end)
+{
+    // Records older than one ring behind the newest are overwritten
+    uint64_t newest = written.load(std::memory_order_relaxed);
+    uint64_t count = std::min(end, dumpRecords);
+    if (newest - end + count > capacity) {
+        count = capacity > newest - end ? capacity - (newest - end) : 0;
+    }
+    if (count == 0) return true;
+
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), "_dump%d.tcfr", dumps.load(std::memory_order_relaxed));
+    std::string stem = path.size() > 5 && path.compare(path.size() - 5, 5, ".tcfr") == 0
+                     ? path.substr(0, path.size() - 5) : path;
+    std::string dumpPath = stem + suffix;
+
+    std::FILE* out = std::fopen(dumpPath.c_str(), "wb");
+    if (!out) {
+        std::cerr << "Error opening file for writing: " << dumpPath << std::endl;
+        return false;
+    }
+
+    const auto* live = reinterpret_cast<const FileHeader*>(file.getData());
+    FileHeader header = makeHeader(count, count, live->physicsDt, live->vehiclesPerStep);
+    bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1;
+
+    // Oldest first; the window may wrap around the end of the ring
+    uint64_t first = (end - count) % capacity;
+    uint64_t tail  = std::min(count, capacity - first);
+    ok = ok && std::fwrite(slots + first, sizeof(TelemetryRecord), tail, out) == tail;
+    ok = ok && std::fwrite(slots, sizeof(TelemetryRecord), count - tail, out) == count - tail;
+    ok = (std::fclose(out) == 0) && ok;
+    if (!ok) {
+        std::cerr << "Error writing flight recorder dump: " << dumpPath << std::endl;
+    }
+    return ok;
+}
+
+bool FlightRecorder::load(const std::string& path, std::vector<TelemetryRecord>& out)
+{
+    out.clear();
+    MappedFile in;
+    if (!in.open(path)) return false;
+
+    FileHeader header{};
+    bool ok = in.getSize() >= sizeof(header);
+    if (ok) {
+        std::memcpy(&header, in.getData(), sizeof(header));
+        ok = std::memcmp(header.magic, kMagic, 4) == 0 &&
+             header.version == kVersion &&
+             header.recordBytes == sizeof(TelemetryRecord) &&
+             header.capacity > 0 &&
+             in.getSize() >= sizeof(header) + header.capacity * sizeof(TelemetryRecord);
+    }
+    if (!ok) {
+        std::cerr << "Not a valid flight recorder file: " << path << std::endl;
+        return false;
+    }
+
+    const unsigned char* records = in.getData() + sizeof(header);
+    uint64_t count = std::min(header.count, header.capacity);
+    out.resize(count);
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t slot = (header.count - count + i) % header.capacity;
+        std::memcpy(&out[i], records + slot * sizeof(TelemetryRecord), sizeof(TelemetryRecord));
+    }
+    return true;
+}
@@ -0,0 +1,392 @@
+#include "FrameRecorder.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+// --- PNG: RGB8, Sub filter, deflate with fixed Huffman codes -----------------
+//
+// Rendered frames are mostly flat color, which the Sub filter turns into long
+// runs of zeros. Runs are coded as distance-1 matches, so no zlib is needed
+// and a typical frame still shrinks by two orders of magnitude.
+
+uint32_t crc32(const uint8_t* data, std::size_t size, uint32_t crc = 0)
+{
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[n] = c;
+        }
+        return t;
+    }();
+    crc = ~crc;
+    for (std::size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+// Big-endian, as PNG and zlib store integers
+void put32(std::vector<uint8_t>& out, uint32_t v)
+{
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out.push_back((uint8_t)(v >> shift));
+    }
+}
+
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out(out) {}
+
+    // Deflate packs values LSB first...
+    void bits(uint32_t value, int count)
+    {
+        buffer |= (uint64_t)value << used;
+        used += count;
+        while (used >= 8) {
+            out.push_back((uint8_t)buffer);
+            buffer >>= 8;
+            used -= 8;
+        }
+    }
+
+    // ...but Huffman codes MSB first
+    void code(uint32_t value, int count)
+    {
+        uint32_t reversed = 0;
+        for (int i = 0; i < count; i++) {
+            reversed |= ((value >> i) & 1) << (count - 1 - i);
+        }
+        bits(reversed, count);
+    }
+
+    void flush()
+    {
+        if (used > 0) out.push_back((uint8_t)buffer);
+        buffer = 0;
+        used = 0;
+    }
+
+private:
+    std::vector<uint8_t>& out;
+    uint64_t buffer = 0;
+    int used = 0;
+};
+
+void literal(BitWriter& w, int symbol)
+{
+    if (symbol < 144)      w.code(0x30 + symbol, 8);
+    else if (symbol < 256) w.code(0x190 + symbol - 144, 9);
+    else if (symbol < 280) w.code(symbol - 256, 7);
+    else                   w.code(0xC0 + symbol - 280, 8);
+}
+
+void match(BitWriter& w, int length)
+{
+    static const int base[29]  = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const int extra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    int c = 28;
+    while (base[c] > length) c--;
+    literal(w, 257 + c);
+    w.bits(length - base[c], extra[c]);
+    w.code(0, 5);  // distance code 0: distance 1
+}
+
+// zlib stream of one fixed-Huffman deflate block
+void deflate(const std::vector<uint8_t>& data, std::vector<uint8_t>& out)
+{
+    out.push_back(0x78);
+    out.push_back(0x01);
+
+    BitWriter w(out);
+    w.bits(1, 1);  // final block
+    w.bits(1, 2);  // fixed Huffman codes
+    std::size_t i = 0;
+    while (i < data.size()) {
+        std::size_t run = 0;
+        if (i > 0) {
+            while (run < 258 && i + run < data.size() && data[i + run] == data[i - 1]) run++;
+        }
+        if (run >= 3) {
+            match(w, (int)run);
+            i += run;
+        } else {
+            literal(w, data[i]);
+            i++;
+        }
+    }
+    literal(w, 256);  // end of block
+    w.flush();
+
+    uint32_t a = 1, b = 0;
+    for (uint8_t byte : data) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    put32(out, (b << 16) | a);
+}
+
+void chunk(std::vector<uint8_t>& png, const char* type, const std::vector<uint8_t>& data)
+{
+    put32(png, (uint32_t)data.size());
+    std::size_t start = png.size();
+    png.insert(png.end(), type, type + 4);
+    png.insert(png.end(), data.begin(), data.end());
+    put32(png, crc32(&png[start], png.size() - start));
+}
+
+bool endsWith(const std::string& s, const std::string& suffix)
+{
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+FrameRecorder::~FrameRecorder()
+{
+    close();
+}
+
+bool FrameRecorder::open(const std::string& path_, int width_, int height_, const FrameRecorderOptions& options)
+{
+    close();
+    if (width_ <= 0 || height_ <= 0) {
+        std::cerr << "Invalid frame size " << width_ << "x" << height_ << std::endl;
+        return false;
+    }
+
+    if (endsWith(path_, ".y4m")) {
+        format = Format::Y4m;
+    } else if (endsWith(path_, ".png")) {
+        format = Format::Png;
+    } else {
+        std::cerr << "Recording needs a .y4m or .png path: " << path_ << std::endl;
+        return false;
+    }
+
+    path   = path_;
+    width  = width_;
+    height = height_;
+
+    if (format == Format::Y4m) {
+        video = std::fopen(path.c_str(), "wb");
+        if (!video) {
+            std::cerr << "Error opening file for writing: " << path << std::endl;
+            return false;
+        }
+        std::fprintf(video, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, std::max(options.fps, 1));
+    }
+
+    int frames = std::max(options.queueFrames, 1);
+    buffers.assign(frames, std::vector<uint8_t>((std::size_t)width * height * 3));
+    freeFrames.clear();
+    readyFrames.clear();
+    for (int i = 0; i < frames; i++) {
+        freeFrames.push_back(i);
+    }
+    current      = -1;
+    dropWhenFull = options.dropWhenFull;
+    stopping     = false;
+    failed       = false;
+    written      = 0;
+    dropped      = 0;
+
+    writer = std::thread(&FrameRecorder::writeLoop, this);
+    return true;
+}
+
+uint8_t* FrameRecorder::acquireFrame()
+{
+    if (!isOpen()) return nullptr;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (current >= 0) {
+        return buffers[current].data();  // not submitted yet; reuse it
+    }
+    if (freeFrames.empty() && dropWhenFull) {
+        dropped++;
+        return nullptr;
+    }
+    frameFree.wait(lock, [this] { return !freeFrames.empty(); });
+    current = freeFrames.front();
+    freeFrames.pop_front();
+    return buffers[current].data();
+}
+
+void FrameRecorder::submitFrame()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (current < 0) return;
+        readyFrames.push_back(current);
+        current = -1;
+    }
+    frameReady.notify_one();
+}
+
+bool FrameRecorder::close()
+{
+    if (!isOpen()) return !failed;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (current >= 0) {
+            freeFrames.push_back(current);  // acquired but never submitted
+            current = -1;
+        }
+        stopping = true;
+    }
+    frameReady.notify_one();
+    writer.join();
+
+    if (video) {
+        if (std::fclose(video) != 0) failed = true;
+        video = nullptr;
+    }
+    if (failed) {
+        std::cerr << "Error writing recording: " << path << std::endl;
+    }
+    buffers.clear();
+    return !failed;
+}
+
+long long FrameRecorder::framesWritten() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return written;
+}
+
+long long FrameRecorder::framesDropped() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return dropped;
+}
+
+void FrameRecorder::writeLoop()
+{
+    std::vector<uint8_t> scratch;
+    long long index = 0;
+    for (;;) {
+        int frame;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            frameReady.wait(lock, [this] { return stopping || !readyFrames.empty(); });
+            if (readyFrames.empty()) return;  // stopping and drained
+            frame = readyFrames.front();
+            readyFrames.pop_front();
+        }
+
+        // After a failure frames are only recycled, so the producer never
+        // blocks for good (failed is only written by this thread meanwhile)
+        bool ok = !failed && writeFrame(buffers[frame].data(), index++, scratch);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (ok) {
+                written++;
+            } else {
+                failed = true;
+            }
+            freeFrames.push_back(frame);
+        }
+        frameFree.notify_one();
+    }
+}
+
+bool FrameRecorder::writeFrame(const uint8_t* rgb, long long index, std::vector<uint8_t>& scratch)
+{
+    if (format == Format::Png) {
+        char number[32];
+        std::snprintf(number, sizeof(number), "_%06lld.png", index);
+        return writePng(path.substr(0, path.size() - 4) + number, rgb, width, height);
+    }
+
+    scratch.resize((std::size_t)width * height + 2 * (std::size_t)((width + 1) / 2) * ((height + 1) / 2));
+    rgbToYuv420(rgb, width, height, scratch.data());
+    return std::fputs("FRAME\n", video) >= 0 &&
+           std::fwrite(scratch.data(), 1, scratch.size(), video) == scratch.size();
+}
+
+bool FrameRecorder::writePng(const std::string& path, const uint8_t* rgb, int width, int height)
+{
+    // Sub filter: every byte minus the same channel of the pixel to its left
+    const std::size_t stride = (std::size_t)width * 3;
+    std::vector<uint8_t> filtered;
+    filtered.reserve((stride + 1) * height);
+    for (int y = 0; y < height; y++) {
+        const uint8_t* row = rgb + y * stride;
+        filtered.push_back(1);
+        for (std::size_t x = 0; x < stride; x++) {
+            filtered.push_back((uint8_t)(row[x] - (x >= 3 ? row[x - 3] : 0)));
+        }
+    }
+
+    std::vector<uint8_t> header;
+    put32(header, (uint32_t)width);
+    put32(header, (uint32_t)height);
+    header.insert(header.end(), {8, 2, 0, 0, 0});  // 8-bit RGB, no interlace
+
+    std::vector<uint8_t> compressed;
+    deflate(filtered, compressed);
+
+    static const uint8_t kSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    std::vector<uint8_t> png(kSignature, kSignature + 8);
+    chunk(png, "IHDR", header);
+    chunk(png, "IDAT", compressed);
+    chunk(png, "IEND", {});
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error opening file for writing: " << path << std::endl;
+        return false;
+    }
+    bool ok = std::fwrite(png.data(), 1, png.size(), file) == png.size();
+    ok = (std::fclose(file) == 0) && ok;
+    return ok;
+}
+
+void FrameRecorder::rgbToYuv420(const uint8_t* rgb, int width, int height, uint8_t* yuv)
+{
+    // Studio-range BT.601, chroma averaged over 2x2 blocks (edges clamp)
+    const int cw = (width + 1) / 2;
+    const int ch = (height + 1) / 2;
+    uint8_t* yPlane = yuv;
+    uint8_t* uPlane = yuv + (std::size_t)width * height;
+    uint8_t* vPlane = uPlane + (std::size_t)cw * ch;
+
+    for (int y = 0; y < height; y++) {
+        const uint8_t* p = rgb + (std::size_t)y * width * 3;
+        for (int x = 0; x < width; x++, p += 3) {
+            yPlane[(std::size_t)y * width + x] = (uint8_t)(((66 * p[0] + 129 * p[1] + 25 * p[2] + 128) >> 8) + 16);
+        }
+    }
+
+    for (int cy = 0; cy < ch; cy++) {
+        for (int cx = 0; cx < cw; cx++) {
+            int r = 0, g = 0, b = 0;
+            for (int dy = 0; dy < 2; dy++) {
+                for (int dx = 0; dx < 2; dx++) {
+                    int x = std::min(2 * cx + dx, width - 1);
+                    int y = std::min(2 * cy + dy, height - 1);
+                    const uint8_t* p = rgb + ((std::size_t)y * width + x) * 3;
+                    r += p[0];
+                    g += p[1];
+                    b += p[2];
+                }
+            }
+            r = (r + 2) / 4;
+            g = (g + 2) / 4;
+            b = (b + 2) / 4;
+            uPlane[(std::size_t)cy * cw + cx] = (uint8_t)(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            vPlane[(std::size_t)cy * cw + cx] = (uint8_t)(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+}
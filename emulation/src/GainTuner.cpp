@@ -0,0 +1,213 @@
+#include "GainTuner.h"
+#include "CmaEs.h"
+#include <algorithm>
+#include <random>
+
+namespace {
+
+const double kDesiredSlip     = 0.1;
+const int    kTractionSteps   = 500;   // 5 s at 100 Hz
+const int    kBrakingSteps    = 1500;  // 15 s, enough to stop on ice from 25 m/s
+const double kBoundsPenalty   = 10.0;  // per squared unit-cube distance outside the box
+
+const double kFrictions[]       = {0.3, 0.6, 1.0};
+const double kTractionSpeeds[]  = {5.0, 15.0, 25.0};
+const double kBrakingSpeeds[]   = {15.0, 25.0};
+
+std::vector<double> toVector(const TractionGains& g)
+{
+    return {g.maxBrakeTorque, g.maxDriveTorque, g.brakeRampRate, g.driveRampRate};
+}
+
+} // namespace
+
+GainTuner::GainTuner(int numThreads, std::uint64_t seed_, double frictionNoise_)
+    : batch(numThreads, seed_),
+      seed(seed_),
+      frictionNoise(frictionNoise_)
+{
+    lower = {50.0, 50.0, 50.0, 50.0};
+    upper = {800.0, 400.0, 5000.0, 3000.0};
+
+    for (double mu : kFrictions) {
+        for (double v : kTractionSpeeds) {
+            Scenario s;
+            s.friction      = mu;
+            s.initialSpeed  = v;
+            s.desiredSlip   = kDesiredSlip;
+            s.steps         = kTractionSteps;
+            s.frictionNoise = frictionNoise;
+            scenarios.push_back(s);
+        }
+    }
+    tractionScenarios = (int)scenarios.size();
+
+    for (double mu : kFrictions) {
+        for (double v : kBrakingSpeeds) {
+            Scenario s;
+            s.friction      = mu;
+            s.initialSpeed  = v;
+            s.desiredSlip   = -kDesiredSlip;
+            s.steps         = kBrakingSteps;
+            s.frictionNoise = frictionNoise;
+            scenarios.push_back(s);
+        }
+    }
+}
+
+TractionGains GainTuner::fromUnit(const std::vector<double>& u) const
+{
+    auto lo = toVector(lower);
+    auto hi = toVector(upper);
+    std::vector<double> g(4);
+    for (int i = 0; i < 4; i++) {
+        g[i] = lo[i] + std::clamp(u[i], 0.0, 1.0) * (hi[i] - lo[i]);
+    }
+    return {g[0], g[1], g[2], g[3]};
+}
+
+std::vector<TuningResult> GainTuner::evaluate(const std::vector<TractionGains>& candidates)
+{
+    // Candidate-major: entry c * S + s runs scenario s with candidate c
+    std::vector<Scenario> all;
+    all.reserve(candidates.size() * scenarios.size());
+    for (const auto& gains : candidates) {
+        for (Scenario s : scenarios) {
+            s.gains = gains;
+            all.push_back(s);
+        }
+    }
+
+    auto rollouts = batch.run(all);
+
+    const auto& last = batch.lastStats();
+    stats.scenarios += last.scenarios;
+    stats.threads    = last.threads;
+    stats.seconds   += last.seconds;
+    stats.scenariosPerSecond = (stats.seconds > 0.0) ? stats.scenarios / stats.seconds : 0.0;
+
+    const int perCandidate = (int)scenarios.size();
+    const int braking = perCandidate - tractionScenarios;
+    std::vector<TuningResult> results(candidates.size());
+    for (std::size_t c = 0; c < candidates.size(); c++) {
+        const ScenarioResult* r = &rollouts[c * perCandidate];
+        TuningResult& out = results[c];
+        out.gains = candidates[c];
+        out.slipError = 0.0;
+        out.stoppingDistance = 0.0;
+        for (int s = 0; s < tractionScenarios; s++) {
+            out.slipError += r[s].meanSlipError;
+        }
+        for (int s = tractionScenarios; s < perCandidate; s++) {
+            out.stoppingDistance += r[s].stoppingDistance;
+        }
+        out.slipError /= tractionScenarios;
+        out.stoppingDistance /= braking;
+    }
+    return results;
+}
+
+std::vector<TuningResult> GainTuner::gridSearch(int pointsPerAxis)
+{
+    pointsPerAxis = std::max(pointsPerAxis, 1);
+    auto axis = [&](int i) { return pointsPerAxis > 1 ? (double)i / (pointsPerAxis - 1) : 0.5; };
+
+    std::vector<TractionGains> candidates;
+    for (int a = 0; a < pointsPerAxis; a++) {
+        for (int b = 0; b < pointsPerAxis; b++) {
+            for (int c = 0; c < pointsPerAxis; c++) {
+                for (int d = 0; d < pointsPerAxis; d++) {
+                    candidates.push_back(fromUnit({axis(a), axis(b), axis(c), axis(d)}));
+                }
+            }
+        }
+    }
+    return evaluate(candidates);
+}
+
+std::vector<TuningResult> GainTuner::randomSearch(int samples)
+{
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    std::vector<TractionGains> candidates;
+    for (int i = 0; i < samples; i++) {
+        std::vector<double> u(4);
+        for (auto& x : u) x = unit(rng);
+        candidates.push_back(fromUnit(u));
+    }
+    return evaluate(candidates);
+}
+
+std::vector<TuningResult> GainTuner::cmaEs(int generations, int population, int runs)
+{
+    runs = std::max(runs, 1);
+
+    // Objectives are normalized by the scores of the default gains
+    TuningResult reference = evaluate({TractionGains()})[0];
+    std::vector<TuningResult> history{reference};
+
+    // Start every run from the defaults
+    auto lo = toVector(lower);
+    auto hi = toVector(upper);
+    auto start = toVector(TractionGains());
+    for (int i = 0; i < 4; i++) {
+        start[i] = (start[i] - lo[i]) / (hi[i] - lo[i]);
+    }
+
+    std::vector<CmaEs> optimizers;
+    std::vector<double> weights;
+    for (int r = 0; r < runs; r++) {
+        optimizers.emplace_back(start, 0.3, population, seed + r);
+        weights.push_back(runs > 1 ? (double)r / (runs - 1) : 0.5);
+    }
+
+    for (int g = 0; g < generations; g++) {
+        std::vector<std::vector<std::vector<double>>> asked;
+        std::vector<TractionGains> candidates;
+        for (auto& es : optimizers) {
+            asked.push_back(es.ask());
+            for (const auto& u : asked.back()) {
+                candidates.push_back(fromUnit(u));
+            }
+        }
+
+        auto results = evaluate(candidates);
+        history.insert(history.end(), results.begin(), results.end());
+
+        std::size_t next = 0;
+        for (int r = 0; r < runs; r++) {
+            std::vector<double> fitness;
+            for (const auto& u : asked[r]) {
+                const TuningResult& res = results[next++];
+                double f = weights[r] * res.slipError / reference.slipError
+                         + (1.0 - weights[r]) * res.stoppingDistance / reference.stoppingDistance;
+                for (double x : u) {
+                    double outside = std::max(0.0, -x) + std::max(0.0, x - 1.0);
+                    f += kBoundsPenalty * outside * outside;
+                }
+                fitness.push_back(f);
+            }
+            optimizers[r].tell(asked[r], fitness);
+        }
+    }
+    return history;
+}
+
+std::vector<TuningResult> GainTuner::paretoFront(const std::vector<TuningResult>& results)
+{
+    std::vector<TuningResult> sorted = results;
+    std::sort(sorted.begin(), sorted.end(), [](const TuningResult& a, const TuningResult& b) {
+        if (a.slipError != b.slipError) return a.slipError < b.slipError;
+        return a.stoppingDistance < b.stoppingDistance;
+    });
+
+    // Sweep by increasing slip error, keeping strict improvements in distance
+    std::vector<TuningResult> front;
+    for (const auto& r : sorted) {
+        if (front.empty() || r.stoppingDistance < front.back().stoppingDistance) {
+            front.push_back(r);
+        }
+    }
+    return front;
+}
@@ -0,0 +1,175 @@
+#include "MappedFile.h"
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path)
+{
+    close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Error opening file: " << path << std::endl;
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        std::cerr << "Cannot map empty file: " << path << std::endl;
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        std::cerr << "Error mapping file: " << path << std::endl;
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle    = file;
+    mappingHandle = mapping;
+    data = static_cast<unsigned char*>(view);
+    size = static_cast<std::size_t>(fileSize.QuadPart);
+    return true;
+}
+
+bool MappedFile::create(const std::string& path, std::size_t newSize)
+{
+    close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Error creating file: " << path << std::endl;
+        return false;
+    }
+
+    // The mapping extends the file to its size
+    ULARGE_INTEGER mappingSize;
+    mappingSize.QuadPart = newSize;
+    HANDLE mapping = newSize ? CreateFileMappingA(file, nullptr, PAGE_READWRITE, mappingSize.HighPart,
+                                                  mappingSize.LowPart, nullptr) : nullptr;
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, 0) : nullptr;
+    if (!view) {
+        std::cerr << "Error mapping file: " << path << std::endl;
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle    = file;
+    mappingHandle = mapping;
+    data = static_cast<unsigned char*>(view);
+    size = newSize;
+    writable = true;
+    return true;
+}
+
+void MappedFile::flush()
+{
+    if (data && writable) FlushViewOfFile(data, 0);
+}
+
+void MappedFile::close()
+{
+    if (data) UnmapViewOfFile(data);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    data = nullptr;
+    size = 0;
+    writable = false;
+    fileHandle = mappingHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path)
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error opening file: " << path << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        std::cerr << "Cannot map empty file: " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, (std::size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // the mapping keeps the file referenced
+    if (view == MAP_FAILED) {
+        std::cerr << "Error mapping file: " << path << std::endl;
+        return false;
+    }
+
+    data = static_cast<unsigned char*>(view);
+    size = (std::size_t)st.st_size;
+    return true;
+}
+
+bool MappedFile::create(const std::string& path, std::size_t newSize)
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error creating file: " << path << std::endl;
+        return false;
+    }
+    if (newSize == 0 || ftruncate(fd, (off_t)newSize) != 0) {
+        std::cerr << "Error sizing file: " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        std::cerr << "Error mapping file: " << path << std::endl;
+        return false;
+    }
+
+    data = static_cast<unsigned char*>(view);
+    size = newSize;
+    writable = true;
+    return true;
+}
+
+void MappedFile::flush()
+{
+    if (data && writable) msync(data, size, MS_ASYNC);
+}
+
+void MappedFile::close()
+{
+    if (data) munmap(data, size);
+    data = nullptr;
+    size = 0;
+    writable = false;
+}
+
+#endif
@@ -1,48 +1,214 @@
 #include "Simulation.h"
+#include <algorithm>
 #include <thread>
 #include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+
+const double kFrameSeconds = 1.0 / 60;   // render pace without vsync
+const double kRenderBudget = 1.0 / 30;   // a frame may wait for one vsync
+const double kMinVsyncFrame = 1.0 / 240; // cap if "vsync" does not block (e.g. minimized)
+const int kMaxCatchUpSteps = 5;
+
+std::vector<Vehicle> copyVehicles(const std::vector<std::shared_ptr<Vehicle>>& vehicles)
+{
+    std::vector<Vehicle> copies;
+    for (const auto& v : vehicles) {
+        copies.push_back(*v);
+    }
+    return copies;
+}
+
+} // namespace
 
 Simulation::Simulation(std::shared_ptr<Vehicle> vehicle,
                        std::shared_ptr<TractionControl> tc,
-                       std::shared_ptr<Visualizer> vis)
-    : vehicle(std::move(vehicle)),
-    tractionControl(std::move(tc)),
-    visualizer(std::move(vis))
+                       std::shared_ptr<Visualizer> vis,
+                       const SimulationOptions& options)
+    : Simulation(std::vector<std::shared_ptr<Vehicle>>{std::move(vehicle)},
+                 std::vector<std::shared_ptr<TractionControl>>{std::move(tc)},
+                 std::move(vis), options)
 {}
 
+Simulation::Simulation(std::vector<std::shared_ptr<Vehicle>> vehicles_,
+                       std::vector<std::shared_ptr<TractionControl>> controllers_,
+                       std::shared_ptr<Visualizer> vis,
+                       const SimulationOptions& options)
+    : vehicles(std::move(vehicles_)),
+    controllers(std::move(controllers_)),
+    visualizer(std::move(vis)),
+    options(options),
+    physics(kPhysicsDt, kMaxCatchUpSteps, options.timeScale),
+    snapshots(copyVehicles(vehicles)),
+    maxSteps(options.duration > 0.0 ? (long long)std::llround(options.duration / kPhysicsDt) : 0),
+    // Real-time budget: the whole control step has to fit in physicsDt
+    controlTime(profiler.add("control", kPhysicsDt)),
+    physicsTime(profiler.add("physics", kPhysicsDt)),
+    stepTime(profiler.add("step", kPhysicsDt)),
+    renderTime(profiler.add("render", kRenderBudget))
+{
+    if (vehicles.empty() || vehicles.size() != controllers.size()) {
+        std::cerr << "Simulation needs one traction controller per vehicle" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    if (visualizer && visualizer->isOffscreen() && maxSteps == 0) {
+        std::cerr << "Offscreen simulation needs a duration" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+bool Simulation::step()
+{
+    ScopedTimer stepTimer(stepTime);
+
+    // A) Update traction control => sets torque
+    {
+        ScopedTimer timer(controlTime);
+        for (std::size_t i = 0; i < vehicles.size(); i++) {
+            controllers[i]->update(*vehicles[i], kPhysicsDt);
+        }
+    }
+
+    // B) Advance vehicle physics
+    {
+        ScopedTimer timer(physicsTime);
+        for (const auto& vehicle : vehicles) {
+            vehicle->update(kPhysicsDt);
+        }
+    }
+
+    stepCount++;
+    if (flightRecorder) {
+        for (std::size_t i = 0; i < vehicles.size(); i++) {
+            flightRecorder->record(*vehicles[i], (int)i, (uint64_t)stepCount, stepCount * kPhysicsDt);
+        }
+    }
+
+    // C) Hand a copy to the renderer (reuses the snapshot's wheel storage),
+    // and every step of the first vehicle to its charts
+    if (visualizer && visualizer->hasCharts()) {
+        TelemetryRecord record;
+        captureTelemetry(*vehicles[0], 0, (uint64_t)stepCount, stepCount * kPhysicsDt, record);
+        visualizer->pushTelemetry(record);
+    }
+    if (visualizer) {
+        std::vector<Vehicle>& copies = snapshots.writeBuffer();
+        for (std::size_t i = 0; i < vehicles.size(); i++) {
+            copies[i] = *vehicles[i];
+        }
+        snapshots.publish();
+    }
+
+    return maxSteps == 0 || stepCount < maxSteps;
+}
+
 void Simulation::run()
 {
-    using clock = std::chrono::steady_clock;
+    auto wallStart = std::chrono::steady_clock::now();
 
-    const double physicsDt = 0.01; // 10 ms
-    double accumulator = 0.0;
+    StepStats stats;
+    if (visualizer && visualizer->isOffscreen()) {
+        renderOffscreen();
+        stats.steps = stepCount;
+    } else {
+        // Physics owns vehicle and tractionControl from here until it stops
+        physics.start([this] { return step(); });
 
-    auto prevTime = clock::now();
+        if (visualizer) {
+            renderLoop();
+            physics.stop();
+        } else {
+            physics.wait();
+        }
+        stats = physics.getStats();
+    }
 
-    while (visualizer->isRunning()) {
-        // 1) Measure elapsed time in seconds
-        auto currentTime = clock::now();
-        double frameTime = std::chrono::duration<double>(currentTime - prevTime).count();
-        prevTime = currentTime;
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    double simSeconds = stats.steps * kPhysicsDt;
 
-        // 2) Accumulate time
-        accumulator += frameTime;
+    std::cout << "Simulated " << simSeconds << " s in " << wallSeconds << " s ("
+              << (wallSeconds > 0.0 ? simSeconds / wallSeconds : 0.0) << "x real time)" << std::endl;
+    std::cout << "Physics: " << stats.steps << " steps, "
+              << stats.overruns << " overruns, "
+              << stats.droppedSteps << " dropped steps, max step "
+              << stats.maxStepSeconds * 1000.0 << " ms" << std::endl;
+    if (vehicles.size() == 1) {
+        std::cout << "Final speed: " << vehicles[0]->getLinearSpeed() << " m/s" << std::endl;
+    } else {
+        double sum = 0.0, lo = vehicles[0]->getLinearSpeed(), hi = lo;
+        for (const auto& vehicle : vehicles) {
+            sum += vehicle->getLinearSpeed();
+            lo = std::min(lo, vehicle->getLinearSpeed());
+            hi = std::max(hi, vehicle->getLinearSpeed());
+        }
+        std::cout << "Final speed: " << sum / vehicles.size() << " m/s mean over " << vehicles.size()
+                  << " vehicles (" << lo << " to " << hi << ")" << std::endl;
+    }
+    profiler.report(std::cout);
+}
 
-        // 3) While we have enough time accumulated for a physics step
-        while (accumulator >= physicsDt) {
-            // A) Update traction control => sets torque
-            tractionControl->update(*vehicle, physicsDt);
+void Simulation::renderLoop()
+{
+    using clock = std::chrono::steady_clock;
 
-            // B) Advance vehicle physics
-            vehicle->update(physicsDt);
+    const auto framePeriod = std::chrono::duration_cast<clock::duration>(
+        std::chrono::duration<double>(kFrameSeconds));
+    const auto vsyncPeriod = std::chrono::duration_cast<clock::duration>(
+        std::chrono::duration<double>(kMinVsyncFrame));
+    // Unpaced physics is matched by an unpaced renderer (thinned by frame skip)
+    const bool paced = options.timeScale > 0.0;
 
-            accumulator -= physicsDt;
+    auto nextFrame = clock::now();
+    while (visualizer->isRunning() && !physics.isFinished()) {
+        snapshots.update();
+        bool presented;
+        {
+            ScopedTimer timer(renderTime);
+            presented = visualizer->render(snapshots.readBuffer());
         }
+        if (visualizer->takeReportRequest()) {
+            profiler.report(std::cout);
+        }
+
+        if (!paced) continue;
+
+        // With vsync, presenting already waited for the display
+        nextFrame += (presented && visualizer->hasVsync()) ? vsyncPeriod : framePeriod;
+        auto now = clock::now();
+        if (nextFrame < now) {
+            nextFrame = now;  // rendering fell behind; don't try to catch up
+        } else {
+            std::this_thread::sleep_until(nextFrame);
+        }
+    }
+}
 
-        // 4) Render once per loop
-        visualizer->render(*vehicle);
+long long Simulation::offscreenStepsPerFrame() const
+{
+    if (!(options.frameRate > 0.0)) return 1;
+    return std::max(1LL, (long long)std::llround(1.0 / (options.frameRate * kPhysicsDt)));
+}
+
+void Simulation::renderOffscreen()
+{
+    const long long stepsPerFrame = offscreenStepsPerFrame();
 
-        // 5) Sleep a bit to limit CPU usage (e.g. ~20-30 fps render)
-        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    // First and last frame show the initial and the final state
+    snapshots.update();
+    {
+        ScopedTimer timer(renderTime);
+        visualizer->render(snapshots.readBuffer());
+    }
+    bool running = true;
+    while (running) {
+        running = step();
+        if (stepCount % stepsPerFrame == 0 || !running) {
+            snapshots.update();
+            ScopedTimer timer(renderTime);
+            visualizer->render(snapshots.readBuffer());
+        }
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,167 @@
+#include "Snapshot.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+const char     kMagic[4]   = {'T', 'C', 'S', 'N'};
+const uint32_t kVersion    = 1;
+
+struct FileHeader {
+    char     magic[4];
+    uint32_t version;
+    uint32_t recordBytes;
+    uint32_t reserved0;
+    uint64_t count;
+    uint64_t reserved1;
+};
+static_assert(sizeof(FileHeader) == 32, "snapshot file header is 32 bytes");
+
+} // namespace
+
+bool captureSnapshot(const Vehicle& vehicle, const TractionControl& tc, double time,
+                     SimulationSnapshot& out)
+{
+    const auto& wheels = vehicle.getWheels();
+    if (wheels.size() > (std::size_t)SimulationSnapshot::kMaxWheels) {
+        std::cerr << "Cannot snapshot a vehicle with " << wheels.size() << " wheels (max "
+                  << SimulationSnapshot::kMaxWheels << ")" << std::endl;
+        return false;
+    }
+
+    out = SimulationSnapshot{};
+    out.time         = time;
+    out.numWheels    = (uint32_t)wheels.size();
+    out.linearSpeed  = vehicle.getLinearSpeed();
+    out.wheelRadius  = vehicle.wheelRadius;
+    out.mass         = vehicle.mass;
+    out.wheelInertia = vehicle.wheelInertia;
+    out.muPeak       = vehicle.muPeak;
+    out.slipOpt      = vehicle.slipOpt;
+    std::copy(wheels.begin(), wheels.end(), out.wheels);
+    out.desiredSlip  = tc.getDesiredSlip();
+    out.gains        = tc.getGains();
+    return true;
+}
+
+Vehicle restoreVehicle(const SimulationSnapshot& snapshot)
+{
+    Vehicle vehicle(snapshot.linearSpeed, (int)snapshot.numWheels);
+    vehicle.wheelRadius  = snapshot.wheelRadius;
+    vehicle.mass         = snapshot.mass;
+    vehicle.wheelInertia = snapshot.wheelInertia;
+    vehicle.muPeak       = snapshot.muPeak;
+    vehicle.slipOpt      = snapshot.slipOpt;
+    vehicle.restoreState(snapshot.linearSpeed, snapshot.wheels, (int)snapshot.numWheels);
+    return vehicle;
+}
+
+TractionControl restoreController(const SimulationSnapshot& snapshot)
+{
+    return TractionControl(snapshot.desiredSlip, snapshot.gains);
+}
+
+bool saveSnapshots(const std::string& path, const SimulationSnapshot* snapshots, std::size_t count)
+{
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error opening file for writing: " << path << std::endl;
+        return false;
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, 4);
+    header.version     = kVersion;
+    header.recordBytes = sizeof(SimulationSnapshot);
+    header.count       = count;
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              std::fwrite(snapshots, sizeof(SimulationSnapshot), count, file) == count;
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok) {
+        std::cerr << "Error writing snapshot file: " << path << std::endl;
+    }
+    return ok;
+}
+
+bool loadSnapshots(const std::string& path, std::vector<SimulationSnapshot>& out)
+{
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        std::cerr << "Error opening snapshot file: " << path << std::endl;
+        return false;
+    }
+
+    FileHeader header{};
+    bool ok = std::fread(&header, sizeof(header), 1, file) == 1 &&
+              std::memcmp(header.magic, kMagic, 4) == 0 &&
+              header.version == kVersion &&
+              header.recordBytes == sizeof(SimulationSnapshot);
+    if (ok) {
+        // The records must fill the rest of the file exactly, so a corrupt
+        // count is rejected before it sizes the vector
+        long size = std::fseek(file, 0, SEEK_END) == 0 ? std::ftell(file) : -1;
+        uint64_t bytes = size >= (long)sizeof(header) ? (uint64_t)size - sizeof(header) : 0;
+        ok = size >= (long)sizeof(header) &&
+             bytes % sizeof(SimulationSnapshot) == 0 &&
+             header.count == bytes / sizeof(SimulationSnapshot) &&
+             std::fseek(file, sizeof(header), SEEK_SET) == 0;
+    }
+    if (ok) {
+        out.resize(header.count);
+        ok = std::fread(out.data(), sizeof(SimulationSnapshot), out.size(), file) == out.size();
+    }
+    std::fclose(file);
+
+    if (!ok) {
+        std::cerr << "Not a valid snapshot file: " << path << std::endl;
+        out.clear();
+        return false;
+    }
+    for (const auto& s : out) {
+        if (s.numWheels > (uint32_t)SimulationSnapshot::kMaxWheels) {
+            std::cerr << "Corrupt snapshot in " << path << std::endl;
+            out.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+SnapshotArena SnapshotArena::repeat(const SimulationSnapshot& snapshot, std::size_t count)
+{
+    SnapshotArena arena;
+    if (count == 0) return arena;
+
+    auto page = std::make_shared<Page>();
+    std::fill(std::begin(page->snapshots), std::end(page->snapshots), snapshot);
+    arena.pages.assign((count + kPageSnapshots - 1) / kPageSnapshots, page);
+    arena.count = count;
+    return arena;
+}
+
+void SnapshotArena::push(const SimulationSnapshot& snapshot)
+{
+    if (count % kPageSnapshots == 0) {
+        pages.push_back(std::make_shared<Page>());
+    }
+    count++;
+    at(count - 1) = snapshot;
+}
+
+SimulationSnapshot& SnapshotArena::at(std::size_t i)
+{
+    auto& page = pages[i / kPageSnapshots];
+    if (page.use_count() > 1) {
+        page = std::make_shared<Page>(*page);
+    }
+    return page->snapshots[i % kPageSnapshots];
+}
+
+std::size_t SnapshotArena::uniquePages() const
+{
+    return (std::size_t)std::count_if(pages.begin(), pages.end(),
+                                      [](const std::shared_ptr<Page>& p) { return p.use_count() == 1; });
+}
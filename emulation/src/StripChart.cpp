@@ -0,0 +1,170 @@
+#include "StripChart.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+const Uint32 kBackground = 0x181818FF;  // RGBA8888
+const Uint32 kZeroLine   = 0x505050FF;
+
+} // namespace
+
+StripChart::StripChart(SDL_Renderer* renderer_, int columns_, int height_, int traces_,
+                       double lo_, double hi_, bool symmetric_)
+    : renderer(renderer_),
+    columns(std::max(columns_, 2)),
+    height(std::max(height_, 2)),
+    traces(std::max(traces_, 1)),
+    lo(lo_), hi(hi_ > lo_ ? hi_ : lo_ + 1.0),
+    symmetric(symmetric_),
+    colors(traces, 0xFFFFFFFF),
+    minValue((std::size_t)columns * traces),
+    maxValue((std::size_t)columns * traces),
+    valid(columns, 0)
+{
+    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING,
+                                columns, height);
+    if (!texture) {
+        std::cerr << "Chart Texture Creation Error: " << SDL_GetError() << std::endl;
+    }
+}
+
+StripChart::~StripChart()
+{
+    if (texture) SDL_DestroyTexture(texture);
+}
+
+void StripChart::setTraceColor(int trace, Uint8 r, Uint8 g, Uint8 b)
+{
+    if (trace < 0 || trace >= traces) return;
+    colors[trace] = ((Uint32)r << 24) | ((Uint32)g << 16) | ((Uint32)b << 8) | 0xFF;
+    redraw = true;
+}
+
+void StripChart::addSample(long long column, const float* values)
+{
+    if (column < current) return;
+
+    if (column > current) {
+        // Slots skipped since the last sample (e.g. the queue overflowed) stay empty
+        for (long long c = std::max(current + 1, column - columns + 1); c < column; c++) {
+            clearSlot(c);
+        }
+        current = column;
+        std::size_t base = (std::size_t)slotOf(column) * traces;
+        for (int t = 0; t < traces; t++) {
+            minValue[base + t] = maxValue[base + t] = values[t];
+        }
+        valid[slotOf(column)] = 1;
+    } else {
+        std::size_t base = (std::size_t)slotOf(column) * traces;
+        for (int t = 0; t < traces; t++) {
+            minValue[base + t] = std::min(minValue[base + t], values[t]);
+            maxValue[base + t] = std::max(maxValue[base + t], values[t]);
+        }
+    }
+
+    for (int t = 0; t < traces; t++) {
+        growRange(values[t]);
+    }
+}
+
+void StripChart::clearSlot(long long column)
+{
+    valid[slotOf(column)] = 0;
+}
+
+void StripChart::growRange(float value)
+{
+    if (!std::isfinite(value) || (value >= lo && value <= hi)) return;
+
+    if (symmetric) {
+        double m = std::max(std::fabs(lo), std::fabs(hi));
+        while (std::fabs(value) > m) m *= 2.0;
+        lo = -m;
+        hi = m;
+    } else {
+        while (value > hi) hi = lo + (hi - lo) * 2.0;
+        while (value < lo) lo = hi - (hi - lo) * 2.0;
+    }
+    redraw = true;
+}
+
+int StripChart::toY(double value) const
+{
+    double row = (hi - value) / (hi - lo) * (height - 1);
+    return std::min(std::max((int)std::lround(row), 0), height - 1);
+}
+
+void StripChart::drawColumn(long long column, Uint32* pixels, int pitch)
+{
+    const int stride = pitch / (int)sizeof(Uint32);
+    for (int y = 0; y < height; y++) {
+        pixels[y * stride] = kBackground;
+    }
+    if (symmetric) {
+        pixels[toY(0.0) * stride] = kZeroLine;
+    }
+    if (column < 0 || !valid[slotOf(column)]) return;
+
+    // Each trace as a vertical segment from its min to its max in this slot
+    std::size_t base = (std::size_t)slotOf(column) * traces;
+    for (int t = 0; t < traces; t++) {
+        int top    = toY(maxValue[base + t]);
+        int bottom = toY(minValue[base + t]);
+        for (int y = top; y <= bottom; y++) {
+            pixels[y * stride] = colors[t];
+        }
+    }
+}
+
+void StripChart::upload(long long from, long long to)
+{
+    // Columns from..to inclusive, as one or two slot ranges of the ring
+    while (from <= to) {
+        int slot  = slotOf(from);
+        int count = (int)std::min<long long>(to - from + 1, columns - slot);
+        SDL_Rect rect = {slot, 0, count, height};
+        void* pixels;
+        int pitch;
+        if (SDL_LockTexture(texture, &rect, &pixels, &pitch) != 0) {
+            std::cerr << "Chart Texture Lock Error: " << SDL_GetError() << std::endl;
+            return;
+        }
+        for (int i = 0; i < count; i++) {
+            drawColumn(from + i, static_cast<Uint32*>(pixels) + i, pitch);
+        }
+        SDL_UnlockTexture(texture);
+        from += count;
+    }
+}
+
+void StripChart::draw(const SDL_Rect& dst)
+{
+    if (!texture) return;
+
+    // The window ends with the slot being accumulated, which is re-uploaded
+    // every frame; finished slots are uploaded once
+    const long long newest = std::max(current, 0LL);
+    const long long oldest = newest - columns + 1;
+    if (redraw) {
+        upload(oldest, newest);
+        redraw = false;
+    } else {
+        upload(std::max(dirtyFrom, oldest), newest);
+    }
+    dirtyFrom = newest;
+
+    // Scroll: the oldest slot goes to the left edge
+    const int split = slotOf(newest + 1);
+    const int leftW = (int)((long long)dst.w * (columns - split) / columns);
+    SDL_Rect srcA = {split, 0, columns - split, height};
+    SDL_Rect dstA = {dst.x, dst.y, leftW, dst.h};
+    SDL_RenderCopy(renderer, texture, &srcA, &dstA);
+    if (split > 0) {
+        SDL_Rect srcB = {0, 0, split, height};
+        SDL_Rect dstB = {dst.x + leftW, dst.y, dst.w - leftW, dst.h};
+        SDL_RenderCopy(renderer, texture, &srcB, &dstB);
+    }
+}
@@ -0,0 +1,225 @@
+#include "SurfaceProfile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include "MappedFile.h"
+
+namespace {
+
+const char     kMagic[4]   = {'T', 'C', 'S', 'F'};
+const uint32_t kVersion    = 1;
+
+struct FileHeader {
+    char     magic[4];
+    uint32_t version;
+    uint32_t lanes;
+    uint32_t reserved0;
+    uint64_t count;
+    uint64_t reserved1;
+};
+static_assert(sizeof(FileHeader) == 32, "surface file header is 32 bytes");
+
+} // namespace
+
+SurfaceProfile::SurfaceProfile(int numLanes_)
+    : numLanes(std::min(std::max(numLanes_, 1), kMaxLanes))
+{
+}
+
+bool SurfaceProfile::addPoint(double distance, double mu)
+{
+    double point[1 + kMaxLanes] = {distance, mu, mu};
+    return append(point);
+}
+
+bool SurfaceProfile::addPoint(double distance, double leftMu, double rightMu)
+{
+    if (numLanes != 2) {
+        std::cerr << "Left/right friction needs a two-lane surface profile" << std::endl;
+        return false;
+    }
+    double point[1 + kMaxLanes] = {distance, leftMu, rightMu};
+    return append(point);
+}
+
+bool SurfaceProfile::append(const double* point)
+{
+    if (!std::isfinite(point[0]) || (count > 0 && point[0] < data()[(count - 1) * stride()])) {
+        std::cerr << "Surface points must be in non-decreasing distance (got " << point[0] << ")"
+                  << std::endl;
+        return false;
+    }
+
+    // Points added to a loaded profile go to a private copy
+    if (mapping) {
+        owned.assign(mapped, mapped + count * stride());
+        mapping.reset();
+        mapped = nullptr;
+    }
+    owned.insert(owned.end(), point, point + stride());
+    count++;
+    return true;
+}
+
+SurfaceProfile SurfaceProfile::uniform(double mu)
+{
+    SurfaceProfile profile;
+    profile.addPoint(0.0, mu);
+    return profile;
+}
+
+SurfaceProfile SurfaceProfile::icePatch(double mu, double iceMu, double start, double length)
+{
+    SurfaceProfile profile;
+    profile.addPoint(start, mu);
+    profile.addPoint(start, iceMu);
+    profile.addPoint(start + length, iceMu);
+    profile.addPoint(start + length, mu);
+    return profile;
+}
+
+SurfaceProfile SurfaceProfile::wetTransition(double dryMu, double wetMu, double start, double width)
+{
+    SurfaceProfile profile;
+    profile.addPoint(start, dryMu);
+    profile.addPoint(start + width, wetMu);
+    return profile;
+}
+
+SurfaceProfile SurfaceProfile::splitMu(double mu, double leftMu, double rightMu, double start, double length)
+{
+    SurfaceProfile profile(2);
+    profile.addPoint(start, mu, mu);
+    profile.addPoint(start, leftMu, rightMu);
+    profile.addPoint(start + length, leftMu, rightMu);
+    profile.addPoint(start + length, mu, mu);
+    return profile;
+}
+
+std::shared_ptr<SurfaceProfile> SurfaceProfile::create(const std::string& spec)
+{
+    // Sections start 40 m in, about 2-3 s into a typical run
+    if (spec == "ice") return std::make_shared<SurfaceProfile>(icePatch(1.0, 0.15, 40.0, 20.0));
+    if (spec == "wet") return std::make_shared<SurfaceProfile>(wetTransition(1.0, 0.5, 40.0, 10.0));
+    if (spec == "split") return std::make_shared<SurfaceProfile>(splitMu(1.0, 1.0, 0.2, 40.0, 30.0));
+
+    auto profile = std::make_shared<SurfaceProfile>();
+    if (!profile->load(spec)) return nullptr;
+    return profile;
+}
+
+bool SurfaceProfile::load(const std::string& path)
+{
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(path)) return false;
+
+    FileHeader header{};
+    bool ok = file->getSize() >= sizeof(header);
+    if (ok) {
+        std::memcpy(&header, file->getData(), sizeof(header));
+        ok = std::memcmp(header.magic, kMagic, 4) == 0 &&
+             header.version == kVersion &&
+             header.lanes >= 1 && header.lanes <= (uint32_t)kMaxLanes &&
+             header.count >= 1 &&
+             file->getSize() == sizeof(header) + header.count * (1 + header.lanes) * sizeof(double);
+    }
+    if (!ok) {
+        std::cerr << "Not a valid surface profile: " << path << std::endl;
+        return false;
+    }
+
+    // The header keeps the points 8-byte aligned in the (page aligned) mapping
+    const double* points = reinterpret_cast<const double*>(file->getData() + sizeof(header));
+    const std::size_t stride = 1 + header.lanes;
+    for (std::size_t i = 0; i < header.count; i++) {
+        double d = points[i * stride];
+        if (!std::isfinite(d) || (i > 0 && d < points[(i - 1) * stride])) {
+            std::cerr << "Surface profile is not sorted by distance: " << path << std::endl;
+            return false;
+        }
+    }
+
+    numLanes = (int)header.lanes;
+    count    = header.count;
+    owned.clear();
+    mapping  = std::move(file);
+    mapped   = points;
+    return true;
+}
+
+bool SurfaceProfile::save(const std::string& path) const
+{
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error opening file for writing: " << path << std::endl;
+        return false;
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, 4);
+    header.version = kVersion;
+    header.lanes   = numLanes;
+    header.count   = count;
+
+    std::size_t values = count * stride();
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              std::fwrite(data(), sizeof(double), values, file) == values;
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok) {
+        std::cerr << "Error writing surface profile: " << path << std::endl;
+    }
+    return ok;
+}
+
+double SurfaceProfile::at(double distance, int lane) const
+{
+    if (count == 0) return 1.0;
+
+    // First point past `distance`
+    const double* p = data();
+    const int s = stride();
+    std::size_t lo = 0, hi = count;
+    while (lo < hi) {
+        std::size_t mid = (lo + hi) / 2;
+        if (p[mid * s] <= distance) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if (lo == 0) return p[1 + lane];
+    if (lo == count) return p[(count - 1) * s + 1 + lane];
+    const double* a = p + (lo - 1) * s;
+    const double* b = p + lo * s;
+    double t = (distance - a[0]) / (b[0] - a[0]);
+    return a[1 + lane] + t * (b[1 + lane] - a[1 + lane]);
+}
+
+SurfaceProfile::Cursor::Cursor(const SurfaceProfile& profile)
+    : points(profile.data()),
+      count(profile.size()),
+      stride(profile.stride())
+{
+    seek(0.0);
+}
+
+void SurfaceProfile::Cursor::seek(double distance)
+{
+    if (count == 0) return;
+
+    // Last point at or before `distance`; a step moves it by a segment or so
+    while (segment + 1 < count && points[(segment + 1) * stride] <= distance) segment++;
+    while (segment > 0 && points[segment * stride] > distance) segment--;
+
+    lo = points + segment * stride;
+    if (segment + 1 < count && lo[0] <= distance) {
+        hi = lo + stride;
+        t  = (distance - lo[0]) / (hi[0] - lo[0]);
+    } else {
+        hi = lo;  // before the first point or past the last
+        t  = 0.0;
+    }
+}
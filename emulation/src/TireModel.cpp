@@ -0,0 +1,126 @@
+#include "TireModel.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+std::shared_ptr<TireModel> TireModel::create(const std::string& spec)
+{
+    if (spec == "exponential") return std::make_shared<ExponentialTireModel>();
+    if (spec == "pacejka") return std::make_shared<PacejkaTireModel>();
+
+    auto table = std::make_shared<TabulatedTireModel>();
+    if (!table->load(spec)) return nullptr;
+    return table;
+}
+
+double ExponentialTireModel::evaluate(double absSlip) const
+{
+    return 1.0 - std::exp(-shape * absSlip);
+}
+
+double PacejkaTireModel::evaluate(double absSlip) const
+{
+    double bs = B * absSlip;
+    return D * std::sin(C * std::atan(bs - E * (bs - std::atan(bs))));
+}
+
+bool TabulatedTireModel::load(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Error opening tire table: " << path << std::endl;
+        return false;
+    }
+
+    points.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        double slip, mu;
+        if (fields >> slip >> mu) {
+            points.emplace_back(slip, mu);
+        }
+    }
+
+    if (points.empty()) {
+        std::cerr << "Tire table has no points: " << path << std::endl;
+        return false;
+    }
+    if (!std::is_sorted(points.begin(), points.end())) {
+        std::cerr << "Tire table is not sorted by slip: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+double TabulatedTireModel::evaluate(double absSlip) const
+{
+    if (absSlip <= points.front().first) return points.front().second;
+    if (absSlip >= points.back().first) return points.back().second;
+
+    auto hi = std::upper_bound(points.begin(), points.end(), std::make_pair(absSlip, -HUGE_VAL));
+    auto lo = hi - 1;
+    double t = (absSlip - lo->first) / (hi->first - lo->first);
+    return lo->second + t * (hi->second - lo->second);
+}
+
+FrictionTable::FrictionTable(const TireModel& model, double maxSlip_, int size)
+    : maxSlip(maxSlip_)
+{
+    size = std::max(size, 2);
+    values.resize(size);
+    double step = maxSlip / (size - 1);
+    for (int i = 0; i < size; i++) {
+        values[i] = model.evaluate(i * step);
+    }
+    invStep   = 1.0 / step;
+    lastIndex = size - 1;
+}
+
+void FrictionTable::lookup(const double* absSlip, double* mu, std::size_t count) const
+{
+    std::size_t i = 0;
+
+#if defined(__AVX2__)
+    const double* table = values.data();
+    const __m256d scale = _mm256_set1_pd(invStep);
+    const __m256d last  = _mm256_set1_pd(lastIndex);
+    const __m256d tail  = _mm256_set1_pd(values.back());
+    const __m256d zero  = _mm256_setzero_pd();
+    for (; i + 4 <= count; i += 4) {
+        __m256d x = _mm256_mul_pd(_mm256_loadu_pd(absSlip + i), scale);
+        __m256d inside = _mm256_cmp_pd(x, last, _CMP_LT_OQ);
+        x = _mm256_max_pd(_mm256_and_pd(x, inside), zero);
+
+        __m256d fl  = _mm256_floor_pd(x);
+        __m128i idx = _mm256_cvttpd_epi32(fl);
+        __m256d lo  = _mm256_i32gather_pd(table, idx, 8);
+        __m256d hi  = _mm256_i32gather_pd(table + 1, idx, 8);
+        __m256d t   = _mm256_sub_pd(x, fl);
+        __m256d r   = _mm256_add_pd(lo, _mm256_mul_pd(t, _mm256_sub_pd(hi, lo)));
+
+        _mm256_storeu_pd(mu + i, _mm256_blendv_pd(tail, r, inside));
+    }
+#endif
+
+    for (; i < count; i++) {
+        mu[i] = lookup(absSlip[i]);
+    }
+}
+
+double FrictionTable::maxError(const TireModel& model, int probes) const
+{
+    double worst = 0.0;
+    for (int i = 0; i <= probes; i++) {
+        double s = maxSlip * i / probes;
+        worst = std::max(worst, std::fabs(lookup(s) - model.evaluate(s)));
+    }
+    return worst;
+}
@@ -0,0 +1,375 @@
+#include "TraceWriter.h"
+#include "ColumnarDataset.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+namespace {
+
+const char* const kColumnNames[] = {
+    "wheel_index", "slip_ratio", "angular_velocity", "linear_speed",
+    "current_brake_torque", "current_drive_torque",
+    "desired_brake_torque", "desired_drive_torque",
+    "speed_to_velocity_ratio", "excess_drive_torque", "slip_deviation"
+};
+const std::size_t kNumColumns = sizeof(kColumnNames) / sizeof(kColumnNames[0]);
+
+// Values of every column of kColumnNames for one record
+void columnValues(const TraceRecord& rec, double* values)
+{
+    values[0]  = (double)rec.wheelIndex;
+    values[1]  = rec.slipRatio;
+    values[2]  = rec.angularVelocity;
+    values[3]  = rec.linearSpeed;
+    values[4]  = rec.currentBrakeTorque;
+    values[5]  = rec.currentDriveTorque;
+    values[6]  = rec.desiredBrakeTorque;
+    values[7]  = rec.desiredDriveTorque;
+    values[8]  = rec.linearSpeed / (rec.angularVelocity + 1e-6);
+    values[9]  = rec.currentDriveTorque - rec.desiredDriveTorque;
+    values[10] = rec.slipRatio - 0.1;
+}
+
+// Longest formatted row: 8 fields of at most ~14 chars plus separators
+const std::size_t kMaxRowChars = 160;
+
+void putU32(unsigned char* p, uint32_t value)
+{
+    for (int i = 0; i < 4; i++) p[i] = (unsigned char)(value >> (8 * i));
+}
+
+void putU64(unsigned char* p, uint64_t value)
+{
+    putU32(p, (uint32_t)value);
+    putU32(p + 4, (uint32_t)(value >> 32));
+}
+
+void putF32(unsigned char* p, float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    putU32(p, bits);
+}
+
+std::size_t dataOffset()
+{
+    std::size_t header = dataset::kHeaderBytes + kNumColumns * dataset::kColumnBytes;
+    return (header + dataset::kAlignment - 1) / dataset::kAlignment * dataset::kAlignment;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// CsvTraceSink
+
+CsvTraceSink::CsvTraceSink(std::size_t bufferBytes)
+    : buffer(std::max(bufferBytes, kMaxRowChars * 2))
+{}
+
+CsvTraceSink::~CsvTraceSink()
+{
+    close();
+}
+
+bool CsvTraceSink::open(const std::string& path)
+{
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error opening trace file: " << path << std::endl;
+        return false;
+    }
+
+    static const char header[] =
+        "wheel_index,slip_ratio,angular_velocity,linear_speed,"
+        "current_brake_torque,current_drive_torque,"
+        "desired_brake_torque,desired_drive_torque\n";
+    std::memcpy(buffer.data(), header, sizeof(header) - 1);
+    used = sizeof(header) - 1;
+    return true;
+}
+
+bool CsvTraceSink::write(const TraceRecord* records, std::size_t count)
+{
+    if (!file) return false;
+
+    for (std::size_t r = 0; r < count; r++) {
+        if (buffer.size() - used < kMaxRowChars && !flush()) {
+            return false;
+        }
+
+        const TraceRecord& rec = records[r];
+        char* out = buffer.data() + used;
+        char* end = buffer.data() + buffer.size();
+
+        out = std::to_chars(out, end, rec.wheelIndex).ptr;
+        const double fields[] = {
+            rec.slipRatio, rec.angularVelocity, rec.linearSpeed,
+            rec.currentBrakeTorque, rec.currentDriveTorque,
+            rec.desiredBrakeTorque, rec.desiredDriveTorque
+        };
+        for (double value : fields) {
+            *out++ = ',';
+            out = std::to_chars(out, end, value, std::chars_format::general, 6).ptr;
+        }
+        *out++ = '\n';
+
+        used = out - buffer.data();
+    }
+    return true;
+}
+
+bool CsvTraceSink::flush()
+{
+    if (used == 0) return true;
+    bool ok = std::fwrite(buffer.data(), 1, used, file) == used;
+    used = 0;
+    return ok;
+}
+
+bool CsvTraceSink::close()
+{
+    if (!file) return true;
+    bool ok = flush();
+    ok = (std::fclose(file) == 0) && ok;
+    file = nullptr;
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// BinaryTraceSink
+
+BinaryTraceSink::BinaryTraceSink(std::size_t chunkRows_)
+    : chunkRows(std::max<std::size_t>(chunkRows_, 1))
+{}
+
+BinaryTraceSink::~BinaryTraceSink()
+{
+    close();
+}
+
+bool BinaryTraceSink::open(const std::string& path)
+{
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error opening trace file: " << path << std::endl;
+        return false;
+    }
+
+    staging.assign(kNumColumns * chunkRows, 0.0f);
+    stagedRows = 0;
+    numRows = 0;
+    columnMin.assign(kNumColumns, std::numeric_limits<float>::infinity());
+    columnMax.assign(kNumColumns, -std::numeric_limits<float>::infinity());
+
+    // Placeholder header; row count and column ranges are patched in close()
+    std::vector<unsigned char> header(dataOffset(), 0);
+    return std::fwrite(header.data(), 1, header.size(), file) == header.size();
+}
+
+bool BinaryTraceSink::write(const TraceRecord* records, std::size_t count)
+{
+    if (!file) return false;
+
+    for (std::size_t r = 0; r < count; r++) {
+        double values[kNumColumns];
+        columnValues(records[r], values);
+
+        for (std::size_t c = 0; c < kNumColumns; c++) {
+            float v = static_cast<float>(values[c]);
+            staging[c * chunkRows + stagedRows] = v;
+            columnMin[c] = std::min(columnMin[c], v);
+            columnMax[c] = std::max(columnMax[c], v);
+        }
+
+        numRows++;
+        if (++stagedRows == chunkRows && !flushChunk()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BinaryTraceSink::flushChunk()
+{
+    if (stagedRows == 0) return true;
+
+    // Pad the last chunk so every chunk has the same size
+    for (std::size_t c = 0; c < kNumColumns; c++) {
+        std::fill(staging.begin() + c * chunkRows + stagedRows,
+                  staging.begin() + (c + 1) * chunkRows, 0.0f);
+    }
+    stagedRows = 0;
+    return std::fwrite(staging.data(), sizeof(float), staging.size(), file) == staging.size();
+}
+
+bool BinaryTraceSink::close()
+{
+    if (!file) return true;
+
+    bool ok = flushChunk();
+
+    std::vector<unsigned char> header(dataset::kHeaderBytes + kNumColumns * dataset::kColumnBytes, 0);
+    std::memcpy(header.data(), dataset::kMagic, 4);
+    putU32(&header[4], dataset::kVersion);
+    putU32(&header[8], (uint32_t)kNumColumns);
+    putU32(&header[12], (uint32_t)chunkRows);
+    putU64(&header[16], numRows);
+    putU64(&header[24], dataOffset());
+    for (std::size_t c = 0; c < kNumColumns; c++) {
+        unsigned char* desc = &header[dataset::kHeaderBytes + c * dataset::kColumnBytes];
+        std::strncpy(reinterpret_cast<char*>(desc), kColumnNames[c], dataset::kNameBytes - 1);
+        putF32(desc + dataset::kNameBytes, numRows ? columnMin[c] : 0.0f);
+        putF32(desc + dataset::kNameBytes + 4, numRows ? columnMax[c] : 0.0f);
+    }
+
+    ok = ok && std::fseek(file, 0, SEEK_SET) == 0 &&
+         std::fwrite(header.data(), 1, header.size(), file) == header.size();
+    ok = (std::fclose(file) == 0) && ok;
+    file = nullptr;
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// MemoryTraceSink
+
+MemoryTraceSink::MemoryTraceSink(std::vector<Output> outputs_, std::size_t capacity_)
+    : outputs(std::move(outputs_)),
+      capacity(capacity_)
+{
+}
+
+bool MemoryTraceSink::open(const std::string&)
+{
+    rows = 0;
+    return true;
+}
+
+bool MemoryTraceSink::write(const TraceRecord* records, std::size_t count)
+{
+    if (rows + count > capacity) {
+        std::cerr << "MemoryTraceSink: more than " << capacity << " rows" << std::endl;
+        return false;
+    }
+
+    double values[kNumColumns];
+    for (std::size_t r = 0; r < count; r++, rows++) {
+        columnValues(records[r], values);
+        for (const auto& out : outputs) {
+            float* row = out.data + rows * out.columns.size();
+            for (std::size_t c = 0; c < out.columns.size(); c++) {
+                row[c] = static_cast<float>(values[out.columns[c]]);
+            }
+        }
+    }
+    return true;
+}
+
+int MemoryTraceSink::columnIndex(const std::string& name)
+{
+    for (std::size_t c = 0; c < kNumColumns; c++) {
+        if (name == kColumnNames[c]) return (int)c;
+    }
+    return -1;
+}
+
+std::vector<std::string> MemoryTraceSink::columnNames()
+{
+    return std::vector<std::string>(kColumnNames, kColumnNames + kNumColumns);
+}
+
+// ---------------------------------------------------------------------------
+// TraceWriter
+
+TraceWriter::TraceWriter(std::unique_ptr<TraceSink> sink_, std::size_t chunkRecords_, std::size_t maxQueuedChunks_)
+    : sink(std::move(sink_)),
+      chunkRecords(std::max<std::size_t>(chunkRecords_, 1)),
+      maxQueuedChunks(std::max<std::size_t>(maxQueuedChunks_, 1))
+{
+    current.reserve(chunkRecords);
+}
+
+TraceWriter::~TraceWriter()
+{
+    close();
+}
+
+std::unique_ptr<TraceSink> TraceWriter::makeSink(const std::string& format)
+{
+    if (format == "csv") return std::make_unique<CsvTraceSink>();
+    if (format == "bin") return std::make_unique<BinaryTraceSink>();
+    return nullptr;
+}
+
+bool TraceWriter::open(const std::string& path)
+{
+    if (!sink || worker.joinable()) return false;
+    if (!sink->open(path)) return false;
+
+    closing = false;
+    failed  = false;
+    worker  = std::thread(&TraceWriter::run, this);
+    return true;
+}
+
+void TraceWriter::submit()
+{
+    if (current.empty()) return;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    queueChanged.wait(lock, [this] { return pending.size() < maxQueuedChunks; });
+
+    pending.push_back(std::move(current));
+    if (!spare.empty()) {
+        current = std::move(spare.back());
+        spare.pop_back();
+    } else {
+        current = std::vector<TraceRecord>();
+        current.reserve(chunkRecords);
+    }
+    lock.unlock();
+    queueChanged.notify_all();
+}
+
+void TraceWriter::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        queueChanged.wait(lock, [this] { return closing || !pending.empty(); });
+        if (pending.empty()) break; // closing and drained
+
+        std::vector<TraceRecord> chunk = std::move(pending.front());
+        pending.pop_front();
+        lock.unlock();
+        queueChanged.notify_all();
+
+        bool ok = sink->write(chunk.data(), chunk.size());
+
+        chunk.clear();
+        lock.lock();
+        failed = failed || !ok;
+        spare.push_back(std::move(chunk));
+    }
+}
+
+bool TraceWriter::close()
+{
+    if (!worker.joinable()) return !failed;
+
+    submit();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closing = true;
+    }
+    queueChanged.notify_all();
+    worker.join();
+
+    bool ok = sink->close();
+    failed = failed || !ok;
+    if (failed) {
+        std::cerr << "Error writing trace file" << std::endl;
+    }
+    return !failed;
+}
@@ -2,13 +2,13 @@
 #include <algorithm>
 #include <cmath>
 
-TractionControl::TractionControl(double desiredSlip_)
+TractionControl::TractionControl(double desiredSlip_, const TractionGains& gains)
     : desiredSlip(desiredSlip_)
 {
-    maxBrakeTorque = 200.0;   // N·m
-    maxDriveTorque = 150.0;   // N·m
-    brakeRampRate  = 500.0;   // N·m per second
-    driveRampRate  = 300.0;   // N·m per second
+    maxBrakeTorque = gains.maxBrakeTorque;
+    maxDriveTorque = gains.maxDriveTorque;
+    brakeRampRate  = gains.brakeRampRate;
+    driveRampRate  = gains.driveRampRate;
 }
 
 void TractionControl::update(Vehicle& vehicle, double dt)
@@ -3,8 +3,15 @@
 #include <cmath>
 
 Vehicle::Vehicle(double initialSpeed, int numWheels)
-    : linearSpeed(initialSpeed)
+    : wheelRadius(0.3),   // 30 cm
+      mass(1200),         // 1200 kg
+      wheelInertia(1.0),  // 1 kg·m^2 (rough guess)
+      muPeak(1.0),        // friction coefficient for good tires on dry asphalt
+      slipOpt(0.1),       // ~10% slip is often near peak traction
+      linearSpeed(initialSpeed)
 {
+    // Parameters are initialized first so the wheels start rolling at the
+    // vehicle speed instead of reading an uninitialized wheelRadius.
     wheels.resize(numWheels);
     for (auto& w : wheels) {
 
@@ -16,12 +23,6 @@ Vehicle::Vehicle(double initialSpeed, int numWheels)
         w.driveTorque     = 0.0;
         w.rotationAngle   = 0.0;
     }
-
-    wheelRadius  = 0.3;   // 30 cm
-    mass         = 1200;  // 1200 kg
-    wheelInertia = 1.0;   // 1 kg·m^2 (rough guess)
-    muPeak       = 1.0;   // friction coefficient for good tires on dry asphalt
-    slipOpt      = 0.1;   // ~10% slip is often near peak traction
 }
 
 void Vehicle::update(double dt)
@@ -34,10 +35,9 @@ void Vehicle::update(double dt)
     for (int i = 0; i < (int)wheels.size(); i++) {
         double slip = computeSlipRatio(i);
 
-        // "Exponential" friction model that rises with slip, up to muPeak
+        // Friction rises with slip, up to muPeak (see frictionCoefficient)
         double absSlip = std::fabs(slip);
-        double k = 10.0; // shape factor
-        double mu = muPeak * (1.0 - std::exp(-k * absSlip));
+        double mu = frictionCoefficient(i, absSlip);
 
         // We'll assume equal weight distribution
         double normalForce = (mass * 9.81) / wheels.size();
@@ -61,14 +61,23 @@ void Vehicle::update(double dt)
         linearSpeed = 0.0; // no reversing in this demo
     }
 
+    if (integrator != Integrator::Euler || tolerance > 0.0) {
+        substeps = 0;
+        for (int i = 0; i < (int)wheels.size(); i++) {
+            integrateWheel(i, dt);
+        }
+        return;
+    }
+    substeps = (int)wheels.size();
+
     // Now update each wheel's angular velocity from net torque
-    for (auto& w : wheels) {
+    for (int i = 0; i < (int)wheels.size(); i++) {
+        Wheel& w = wheels[i];
         double wheelLinSpeed = w.angularVelocity * wheelRadius;
         double diff          = wheelLinSpeed - linearSpeed;
 
         double absSlip = std::fabs(diff / std::max(linearSpeed, 0.001));
-        double k = 10.0;
-        double mu = muPeak * (1.0 - std::exp(-k * absSlip));
+        double mu = frictionCoefficient(i, absSlip);
         double normalForce = (mass * 9.81) / wheels.size();
         double frictionForce = mu * normalForce;
 
@@ -92,6 +101,176 @@ void Vehicle::update(double dt)
     }
 }
 
+void Vehicle::setIntegrator(Integrator method, double tolerance_, int maxSubsteps)
+{
+    integrator = method;
+    tolerance  = tolerance_;
+    maxLevel   = 0;
+    while (maxLevel < 20 && (2 << maxLevel) <= maxSubsteps) {
+        maxLevel++;
+    }
+}
+
+bool Vehicle::parseIntegrator(const std::string& name, Integrator& method)
+{
+    if (name == "euler") {
+        method = Integrator::Euler;
+    } else if (name == "semi-implicit") {
+        method = Integrator::SemiImplicitEuler;
+    } else if (name == "rk4") {
+        method = Integrator::RK4;
+    } else if (name == "implicit") {
+        method = Integrator::Implicit;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* Vehicle::integratorName(Integrator method)
+{
+    switch (method) {
+        case Integrator::Euler:             return "euler";
+        case Integrator::SemiImplicitEuler: return "semi-implicit";
+        case Integrator::RK4:               return "rk4";
+        case Integrator::Implicit:          return "implicit";
+    }
+    return "unknown";
+}
+
+double Vehicle::wheelAcceleration(int i, double omega) const
+{
+    const Wheel& w = wheels[i];
+    double wheelLinSpeed = omega * wheelRadius;
+    double diff          = wheelLinSpeed - linearSpeed;
+
+    double absSlip = std::fabs(diff / std::max(linearSpeed, 0.001));
+    double mu = frictionCoefficient(i, absSlip);
+    double normalForce = (mass * 9.81) / wheels.size();
+    double frictionForce = mu * normalForce;
+
+    double sign = (wheelLinSpeed >= linearSpeed) ? 1.0 : -1.0;
+    double frictionTorque = frictionForce * wheelRadius * sign;
+
+    return (w.driveTorque - w.brakeTorque - frictionTorque) / wheelInertia;
+}
+
+double Vehicle::wheelAccelerationSlope(int i, double omega) const
+{
+    double denom   = std::max(linearSpeed, 0.001);
+    double absSlip = std::fabs((omega * wheelRadius - linearSpeed) / denom);
+
+    // d(mu)/d|slip|: exact for the exponential curve, the segment slope of a table
+    double dMu;
+    if (tireTable) {
+        const double h = 1e-4;
+        double lo = std::max(absSlip - h, 0.0);
+        dMu = (frictionCoefficient(i, absSlip + h) - frictionCoefficient(i, lo)) / (absSlip + h - lo);
+    } else {
+        double peak = wheelMu.empty() ? muPeak : wheelMu[i];
+        dMu = peak * kFrictionShape * std::exp(-kFrictionShape * absSlip);
+    }
+
+    double normalForce = (mass * 9.81) / wheels.size();
+    return -normalForce * wheelRadius * wheelRadius * dMu / (wheelInertia * denom);
+}
+
+double Vehicle::stepWheel(int i, double omega, double h) const
+{
+    double next = omega;
+    switch (integrator) {
+        case Integrator::Euler:
+            next = omega + wheelAcceleration(i, omega) * h;
+            break;
+        case Integrator::SemiImplicitEuler:
+            next = omega + h * wheelAcceleration(i, omega) / (1.0 - h * wheelAccelerationSlope(i, omega));
+            break;
+        case Integrator::RK4: {
+            double k1 = wheelAcceleration(i, omega);
+            double k2 = wheelAcceleration(i, omega + 0.5 * h * k1);
+            double k3 = wheelAcceleration(i, omega + 0.5 * h * k2);
+            double k4 = wheelAcceleration(i, omega + h * k3);
+            next = omega + h / 6.0 * (k1 + 2.0 * k2 + 2.0 * k3 + k4);
+            break;
+        }
+        case Integrator::Implicit:
+            next = solveImplicit(i, omega, h);
+            break;
+    }
+    return std::max(next, 0.0);
+}
+
+double Vehicle::solveImplicit(int i, double omega, double h) const
+{
+    // Root of g(x) = x - omega - h * f(x). While friction rises with slip, f
+    // falls with x, so the root lies between omega and the explicit step.
+    double a  = omega;
+    double ga = -h * wheelAcceleration(i, a);
+    if (ga == 0.0) return a;
+    double b  = omega - ga;
+    double gb = b - omega - h * wheelAcceleration(i, b);
+    if (gb == 0.0) return b;
+    if ((ga > 0.0) == (gb > 0.0)) {
+        // Falling part of a curve (e.g. Pacejka past its peak): no bracket
+        return omega + h * wheelAcceleration(i, omega) / (1.0 - h * wheelAccelerationSlope(i, omega));
+    }
+
+    // Illinois regula falsi; also converges onto a step in the friction curve
+    double x = b;
+    for (int iter = 0; iter < 60; iter++) {
+        x = b - gb * (b - a) / (gb - ga);
+        double gx = x - omega - h * wheelAcceleration(i, x);
+        if ((gx > 0.0) == (gb > 0.0)) {
+            ga *= 0.5;
+        } else {
+            a  = b;
+            ga = gb;
+        }
+        b  = x;
+        gb = gx;
+        if (std::fabs(gx) <= 1e-12 * (1.0 + std::fabs(x)) || std::fabs(b - a) <= 1e-12 * (1.0 + std::fabs(x))) break;
+    }
+    return x;
+}
+
+void Vehicle::integrateWheel(int i, double dt)
+{
+    Wheel& w = wheels[i];
+
+    // Positions count in units of the smallest substep, so steps of
+    // dt / 2^level stay aligned without rounding drift
+    const long long total = 1LL << maxLevel;
+    long long position = 0;
+    int level = 0;
+    while (position < total) {
+        double h = dt / (double)(1LL << level);
+        double next = stepWheel(i, w.angularVelocity, h);
+        if (tolerance > 0.0 && level < maxLevel) {
+            double half = stepWheel(i, w.angularVelocity, 0.5 * h);
+            half = stepWheel(i, half, 0.5 * h);
+            if (std::fabs(half - next) > tolerance) {
+                level++;
+                continue;
+            }
+            next = half;
+        }
+
+        w.angularVelocity = next;
+        w.rotationAngle  += next * h;
+        substeps++;
+
+        // Try a step twice as long once aligned to it
+        position += total >> level;
+        if (level > 0 && position % (total >> (level - 1)) == 0) {
+            level--;
+        }
+    }
+
+    if (w.rotationAngle > 2.0 * M_PI) {
+        w.rotationAngle = std::fmod(w.rotationAngle, 2.0 * M_PI);
+    }
+}
+
 void Vehicle::setBrakeTorque(int wheelIndex, double torque)
 {
     if (wheelIndex >= 0 && wheelIndex < (int)wheels.size()) {
@@ -109,6 +288,28 @@ void Vehicle::setDriveTorque(int wheelIndex, double torque)
 void Vehicle::setFriction(double friction)
 {
     muPeak = friction;
+    wheelMu.clear();
+}
+
+void Vehicle::setWheelFriction(int wheelIndex, double friction)
+{
+    if (wheelIndex < 0 || wheelIndex >= (int)wheels.size()) return;
+    if (wheelMu.empty()) {
+        wheelMu.assign(wheels.size(), muPeak);
+    }
+    wheelMu[wheelIndex] = friction;
+}
+
+double Vehicle::getWheelFriction(int wheelIndex) const
+{
+    if (wheelIndex < 0 || wheelIndex >= (int)wheels.size()) return 0.0;
+    return wheelMu.empty() ? muPeak : wheelMu[wheelIndex];
+}
+
+void Vehicle::restoreState(double speed, const Wheel* newWheels, int numWheels)
+{
+    linearSpeed = speed;
+    wheels.assign(newWheels, newWheels + numWheels);
 }
 
 double Vehicle::computeSlipRatio(int wheelIndex) const
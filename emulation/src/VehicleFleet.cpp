@@ -0,0 +1,394 @@
+#include "VehicleFleet.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const double kGravity  = 9.81;
+const double kMinSpeed = 0.001;   // same denominator guard as Vehicle::computeSlipRatio
+const double kTwoPi    = 2.0 * M_PI;
+
+// Polynomial exp() shared by the vector kernels: x = n*ln2 + r with
+// |r| <= ln2/2, then a degree-12 Taylor polynomial for e^r and 2^n applied
+// through the exponent bits. Inputs here are always <= 0.
+const double kLog2e = 1.4426950408889634;
+const double kLn2Hi = 6.93145751953125e-1;
+const double kLn2Lo = 1.42860682030941723212e-6;
+const double kExpMin = -708.0;
+const double kExpCoeffs[] = {
+    1.0 / 479001600.0, 1.0 / 39916800.0, 1.0 / 3628800.0, 1.0 / 362880.0,
+    1.0 / 40320.0,     1.0 / 5040.0,     1.0 / 720.0,     1.0 / 120.0,
+    1.0 / 24.0,        1.0 / 6.0,        1.0 / 2.0,       1.0,
+    1.0
+};
+
+#if defined(__AVX512F__)
+
+inline __m512d exp512(__m512d x)
+{
+    x = _mm512_max_pd(x, _mm512_set1_pd(kExpMin));
+    __m512d n = _mm512_roundscale_pd(_mm512_mul_pd(x, _mm512_set1_pd(kLog2e)),
+                                     _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m512d r = _mm512_fnmadd_pd(n, _mm512_set1_pd(kLn2Hi), x);
+    r = _mm512_fnmadd_pd(n, _mm512_set1_pd(kLn2Lo), r);
+
+    __m512d p = _mm512_set1_pd(kExpCoeffs[0]);
+    for (int i = 1; i < 13; i++) {
+        p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(kExpCoeffs[i]));
+    }
+    return _mm512_scalef_pd(p, n);
+}
+
+#elif defined(__AVX2__)
+
+inline __m256d madd256(__m256d a, __m256d b, __m256d c)
+{
+#if defined(__FMA__)
+    return _mm256_fmadd_pd(a, b, c);
+#else
+    return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#endif
+}
+
+inline __m256d exp256(__m256d x)
+{
+    x = _mm256_max_pd(x, _mm256_set1_pd(kExpMin));
+    __m256d n = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(kLog2e)),
+                                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256d r = _mm256_sub_pd(x, _mm256_mul_pd(n, _mm256_set1_pd(kLn2Hi)));
+    r = _mm256_sub_pd(r, _mm256_mul_pd(n, _mm256_set1_pd(kLn2Lo)));
+
+    __m256d p = _mm256_set1_pd(kExpCoeffs[0]);
+    for (int i = 1; i < 13; i++) {
+        p = madd256(p, r, _mm256_set1_pd(kExpCoeffs[i]));
+    }
+
+    // 2^n: n fits in int32 after the clamp above
+    __m256i bits = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(n));
+    bits = _mm256_slli_epi64(_mm256_add_epi64(bits, _mm256_set1_epi64x(1023)), 52);
+    return _mm256_mul_pd(p, _mm256_castsi256_pd(bits));
+}
+
+#endif
+
+} // namespace
+
+VehicleFleet::VehicleFleet(int numVehicles_, int numWheels_, double initialSpeed)
+    : wheelRadius(0.3),
+      mass(1200),
+      wheelInertia(1.0),
+      frictionShape(Vehicle::kFrictionShape),
+      numVehicles(numVehicles_),
+      numWheels(numWheels_)
+{
+    std::size_t n = (std::size_t)numVehicles * numWheels;
+    double initialOmega = (wheelRadius > 1e-5) ? (initialSpeed / wheelRadius) : 0.0;
+
+    angularVelocity.assign(n, initialOmega);
+    brakeTorque.assign(n, 0.0);
+    driveTorque.assign(n, 0.0);
+    rotationAngle.assign(n, 0.0);
+    muPeak.assign(n, 1.0);
+    linearSpeed.assign(numVehicles, initialSpeed);
+
+    wheelVehicleSpeed.assign(n, initialSpeed);
+    frictionForce.assign(n, 0.0);
+}
+
+void VehicleFleet::loadVehicle(int v, const Vehicle& vehicle)
+{
+    if (v < 0 || v >= numVehicles) return;
+
+    wheelRadius  = vehicle.wheelRadius;
+    mass         = vehicle.mass;
+    wheelInertia = vehicle.wheelInertia;
+
+    linearSpeed[v] = vehicle.getLinearSpeed();
+
+    const auto& wheels = vehicle.getWheels();
+    int n = std::min(numWheels, (int)wheels.size());
+    for (int w = 0; w < n; w++) {
+        std::size_t i = index(v, w);
+        angularVelocity[i] = wheels[w].angularVelocity;
+        brakeTorque[i]     = wheels[w].brakeTorque;
+        driveTorque[i]     = wheels[w].driveTorque;
+        rotationAngle[i]   = wheels[w].rotationAngle;
+        muPeak[i]          = vehicle.getWheelFriction(w);
+    }
+}
+
+void VehicleFleet::setBrakeTorque(int v, int w, double torque)
+{
+    brakeTorque[index(v, w)] = std::max(0.0, torque);
+}
+
+void VehicleFleet::setDriveTorque(int v, int w, double torque)
+{
+    driveTorque[index(v, w)] = std::max(0.0, torque);
+}
+
+void VehicleFleet::setFriction(int v, double friction)
+{
+    for (int w = 0; w < numWheels; w++) {
+        muPeak[index(v, w)] = friction;
+    }
+}
+
+double VehicleFleet::computeSlipRatio(int v, int w) const
+{
+    double wheelLinSpeed = angularVelocity[index(v, w)] * wheelRadius;
+    double denom = std::max(linearSpeed[v], kMinSpeed);
+    return (wheelLinSpeed - linearSpeed[v]) / denom;
+}
+
+const char* VehicleFleet::kernelName()
+{
+#if defined(__AVX512F__)
+    return "avx512";
+#elif defined(__AVX2__)
+    return "avx2";
+#else
+    return "scalar";
+#endif
+}
+
+void VehicleFleet::broadcastSpeed()
+{
+    for (int v = 0; v < numVehicles; v++) {
+        std::fill_n(wheelVehicleSpeed.begin() + index(v, 0), numWheels, linearSpeed[v]);
+    }
+}
+
+void VehicleFleet::update(double dt)
+{
+    if (dt <= 0.0) return;
+
+    std::size_t n = angularVelocity.size();
+
+    // 1) Signed friction force of every wheel at the current speed
+    broadcastSpeed();
+    if (tireTable) {
+        tableFrictionKernel();
+    } else {
+        frictionKernel(0, n);
+    }
+
+    // 2) Per-vehicle reduction, summed in wheel order like Vehicle::update
+    for (int v = 0; v < numVehicles; v++) {
+        double totalForce = 0.0;
+        for (int w = 0; w < numWheels; w++) {
+            totalForce += frictionForce[index(v, w)];
+        }
+        double accel = totalForce / mass;
+        linearSpeed[v] += accel * dt;
+        if (linearSpeed[v] < 0.0) {
+            linearSpeed[v] = 0.0;
+        }
+    }
+
+    // 3) Wheel dynamics against the updated vehicle speed
+    broadcastSpeed();
+    if (tireTable) {
+        tableFrictionKernel();
+        tableWheelKernel(dt);
+    } else {
+        wheelKernel(0, n, dt);
+    }
+
+    // Wrapping is rare, keep fmod out of the vector loop
+    for (std::size_t i = 0; i < n; i++) {
+        if (rotationAngle[i] > kTwoPi) {
+            rotationAngle[i] = std::fmod(rotationAngle[i], kTwoPi);
+        }
+    }
+}
+
+void VehicleFleet::frictionKernel(std::size_t begin, std::size_t end)
+{
+    const double normalForce = (mass * kGravity) / numWheels;
+    const double* omega = angularVelocity.data();
+    const double* speed = wheelVehicleSpeed.data();
+    const double* mu    = muPeak.data();
+    double* force       = frictionForce.data();
+    std::size_t i = begin;
+
+#if defined(__AVX512F__)
+    const __m512d r     = _mm512_set1_pd(wheelRadius);
+    const __m512d negK  = _mm512_set1_pd(-frictionShape);
+    const __m512d nf    = _mm512_set1_pd(normalForce);
+    const __m512d one   = _mm512_set1_pd(1.0);
+    const __m512d minV  = _mm512_set1_pd(kMinSpeed);
+    const __m512d zero  = _mm512_setzero_pd();
+    for (; i + 8 <= end; i += 8) {
+        __m512d v    = _mm512_loadu_pd(speed + i);
+        __m512d diff = _mm512_sub_pd(_mm512_mul_pd(_mm512_loadu_pd(omega + i), r), v);
+        __m512d slip = _mm512_div_pd(diff, _mm512_max_pd(v, minV));
+        __m512d m    = _mm512_mul_pd(_mm512_loadu_pd(mu + i),
+                           _mm512_sub_pd(one, exp512(_mm512_mul_pd(negK, _mm512_abs_pd(slip)))));
+        __m512d f    = _mm512_mul_pd(m, nf);
+        __mmask8 neg = _mm512_cmp_pd_mask(diff, zero, _CMP_LT_OQ);
+        _mm512_storeu_pd(force + i, _mm512_mask_sub_pd(f, neg, zero, f));
+    }
+#elif defined(__AVX2__)
+    const __m256d r     = _mm256_set1_pd(wheelRadius);
+    const __m256d negK  = _mm256_set1_pd(-frictionShape);
+    const __m256d nf    = _mm256_set1_pd(normalForce);
+    const __m256d one   = _mm256_set1_pd(1.0);
+    const __m256d minV  = _mm256_set1_pd(kMinSpeed);
+    const __m256d zero  = _mm256_setzero_pd();
+    const __m256d sgn   = _mm256_set1_pd(-0.0);
+    for (; i + 4 <= end; i += 4) {
+        __m256d v    = _mm256_loadu_pd(speed + i);
+        __m256d diff = _mm256_sub_pd(_mm256_mul_pd(_mm256_loadu_pd(omega + i), r), v);
+        __m256d slip = _mm256_div_pd(diff, _mm256_max_pd(v, minV));
+        __m256d m    = _mm256_mul_pd(_mm256_loadu_pd(mu + i),
+                           _mm256_sub_pd(one, exp256(_mm256_mul_pd(negK, _mm256_andnot_pd(sgn, slip)))));
+        __m256d f    = _mm256_mul_pd(m, nf);
+        __m256d neg  = _mm256_cmp_pd(diff, zero, _CMP_LT_OQ);
+        _mm256_storeu_pd(force + i, _mm256_blendv_pd(f, _mm256_sub_pd(zero, f), neg));
+    }
+#endif
+
+    for (; i < end; i++) {
+        double wheelLinSpeed = omega[i] * wheelRadius;
+        double slip    = (wheelLinSpeed - speed[i]) / std::max(speed[i], kMinSpeed);
+        double absSlip = std::fabs(slip);
+        double m       = mu[i] * (1.0 - std::exp(-frictionShape * absSlip));
+        double f       = m * normalForce;
+        double diff    = wheelLinSpeed - speed[i];
+        double sign    = (diff >= 0.0) ? 1.0 : -1.0;
+        force[i] = f * sign;
+    }
+}
+
+void VehicleFleet::wheelKernel(std::size_t begin, std::size_t end, double dt)
+{
+    const double normalForce = (mass * kGravity) / numWheels;
+    const double* speed = wheelVehicleSpeed.data();
+    const double* mu    = muPeak.data();
+    const double* brake = brakeTorque.data();
+    const double* drive = driveTorque.data();
+    double* omega       = angularVelocity.data();
+    double* angle       = rotationAngle.data();
+    std::size_t i = begin;
+
+#if defined(__AVX512F__)
+    const __m512d r     = _mm512_set1_pd(wheelRadius);
+    const __m512d negK  = _mm512_set1_pd(-frictionShape);
+    const __m512d nf    = _mm512_set1_pd(normalForce);
+    const __m512d one   = _mm512_set1_pd(1.0);
+    const __m512d minV  = _mm512_set1_pd(kMinSpeed);
+    const __m512d zero  = _mm512_setzero_pd();
+    const __m512d inertia = _mm512_set1_pd(wheelInertia);
+    const __m512d step  = _mm512_set1_pd(dt);
+    for (; i + 8 <= end; i += 8) {
+        __m512d v    = _mm512_loadu_pd(speed + i);
+        __m512d w    = _mm512_loadu_pd(omega + i);
+        __m512d wls  = _mm512_mul_pd(w, r);
+        __m512d diff = _mm512_sub_pd(wls, v);
+        __m512d absSlip = _mm512_abs_pd(_mm512_div_pd(diff, _mm512_max_pd(v, minV)));
+        __m512d m    = _mm512_mul_pd(_mm512_loadu_pd(mu + i),
+                           _mm512_sub_pd(one, exp512(_mm512_mul_pd(negK, absSlip))));
+        __m512d ft   = _mm512_mul_pd(_mm512_mul_pd(m, nf), r);
+        __mmask8 neg = _mm512_cmp_pd_mask(wls, v, _CMP_LT_OQ);
+        ft = _mm512_mask_sub_pd(ft, neg, zero, ft);
+
+        __m512d net  = _mm512_sub_pd(_mm512_sub_pd(_mm512_loadu_pd(drive + i),
+                                                   _mm512_loadu_pd(brake + i)), ft);
+        __m512d alpha = _mm512_div_pd(net, inertia);
+        w = _mm512_max_pd(_mm512_add_pd(w, _mm512_mul_pd(alpha, step)), zero);
+        _mm512_storeu_pd(omega + i, w);
+        _mm512_storeu_pd(angle + i, _mm512_add_pd(_mm512_loadu_pd(angle + i), _mm512_mul_pd(w, step)));
+    }
+#elif defined(__AVX2__)
+    const __m256d r     = _mm256_set1_pd(wheelRadius);
+    const __m256d negK  = _mm256_set1_pd(-frictionShape);
+    const __m256d nf    = _mm256_set1_pd(normalForce);
+    const __m256d one   = _mm256_set1_pd(1.0);
+    const __m256d minV  = _mm256_set1_pd(kMinSpeed);
+    const __m256d zero  = _mm256_setzero_pd();
+    const __m256d sgn   = _mm256_set1_pd(-0.0);
+    const __m256d inertia = _mm256_set1_pd(wheelInertia);
+    const __m256d step  = _mm256_set1_pd(dt);
+    for (; i + 4 <= end; i += 4) {
+        __m256d v    = _mm256_loadu_pd(speed + i);
+        __m256d w    = _mm256_loadu_pd(omega + i);
+        __m256d wls  = _mm256_mul_pd(w, r);
+        __m256d diff = _mm256_sub_pd(wls, v);
+        __m256d absSlip = _mm256_andnot_pd(sgn, _mm256_div_pd(diff, _mm256_max_pd(v, minV)));
+        __m256d m    = _mm256_mul_pd(_mm256_loadu_pd(mu + i),
+                           _mm256_sub_pd(one, exp256(_mm256_mul_pd(negK, absSlip))));
+        __m256d ft   = _mm256_mul_pd(_mm256_mul_pd(m, nf), r);
+        __m256d neg  = _mm256_cmp_pd(wls, v, _CMP_LT_OQ);
+        ft = _mm256_blendv_pd(ft, _mm256_sub_pd(zero, ft), neg);
+
+        __m256d net  = _mm256_sub_pd(_mm256_sub_pd(_mm256_loadu_pd(drive + i),
+                                                   _mm256_loadu_pd(brake + i)), ft);
+        __m256d alpha = _mm256_div_pd(net, inertia);
+        w = _mm256_max_pd(_mm256_add_pd(w, _mm256_mul_pd(alpha, step)), zero);
+        _mm256_storeu_pd(omega + i, w);
+        _mm256_storeu_pd(angle + i, _mm256_add_pd(_mm256_loadu_pd(angle + i), _mm256_mul_pd(w, step)));
+    }
+#endif
+
+    for (; i < end; i++) {
+        double wheelLinSpeed = omega[i] * wheelRadius;
+        double diff          = wheelLinSpeed - speed[i];
+
+        double absSlip = std::fabs(diff / std::max(speed[i], kMinSpeed));
+        double m       = mu[i] * (1.0 - std::exp(-frictionShape * absSlip));
+        double f       = m * normalForce;
+
+        double sign = (wheelLinSpeed >= speed[i]) ? 1.0 : -1.0;
+        double frictionTorque = f * wheelRadius * sign;
+
+        double netTorque = drive[i] - brake[i] - frictionTorque;
+        double alpha     = netTorque / wheelInertia;
+
+        omega[i] += alpha * dt;
+        if (omega[i] < 0.0) {
+            omega[i] = 0.0;
+        }
+        angle[i] += omega[i] * dt;
+    }
+}
+
+void VehicleFleet::tableFrictionKernel()
+{
+    const double normalForce = (mass * kGravity) / numWheels;
+    const std::size_t n = angularVelocity.size();
+    const double* omega = angularVelocity.data();
+    const double* speed = wheelVehicleSpeed.data();
+    const double* mu    = muPeak.data();
+    double* force       = frictionForce.data();
+
+    // |slip| -> table coefficient in place, then scale and sign
+    for (std::size_t i = 0; i < n; i++) {
+        force[i] = std::fabs((omega[i] * wheelRadius - speed[i]) / std::max(speed[i], kMinSpeed));
+    }
+    tireTable->lookup(force, force, n);
+    for (std::size_t i = 0; i < n; i++) {
+        double f = mu[i] * force[i] * normalForce;
+        force[i] = (omega[i] * wheelRadius - speed[i] >= 0.0) ? f : -f;
+    }
+}
+
+void VehicleFleet::tableWheelKernel(double dt)
+{
+    const std::size_t n = angularVelocity.size();
+    const double* force = frictionForce.data();
+    const double* brake = brakeTorque.data();
+    const double* drive = driveTorque.data();
+    double* omega       = angularVelocity.data();
+    double* angle       = rotationAngle.data();
+
+    for (std::size_t i = 0; i < n; i++) {
+        double netTorque = drive[i] - brake[i] - force[i] * wheelRadius;
+        omega[i] = std::max(omega[i] + netTorque / wheelInertia * dt, 0.0);
+        angle[i] += omega[i] * dt;
+    }
+}
@@ -2,10 +2,111 @@
 #include <iostream>
 #include <cmath>
 #include <algorithm>
+#include <cstring>
 
-Visualizer::Visualizer()
+namespace {
+
+// Every vehicle is laid out in this space and scaled into its tile
+const int kLayoutW = 800;
+const int kLayoutH = 600;
+
+const int kCarW = 120;  // car body
+const int kCarH = 200;
+
+const int kWheelW = 12;
+const int kWheelH = 30;
+const int kTreadPeriod = 8;            // pixels between tread grooves
+const int kGroovesPerRevolution = 12;  // sets the scroll speed of the tread
+
+// Bars of one vehicle share these x ranges, however many wheels it has
+const int kWheelBarsX  = 100;
+const int kSlipBarsX   = 560;
+const int kBarsWidth   = 220;
+const int kMaxBarPitch = 30;
+
+// Strip charts: 600 columns of 0.1 s = 60 s of history
+const int kChartColumns = 600;
+const double kChartColumnSeconds = 0.1;
+const int kChartHeight = 120;        // texture rows, scaled to the window
+const int kTelemetryQueue = 4096;    // steps in flight, 40 s at 100 Hz
+const int kChartGap = 4;             // pixels between charts
+
+// Trace colors per wheel; brake torque uses the same color at half intensity
+const SDL_Color kWheelColors[TelemetryRecord::kMaxWheels] = {
+    {255, 80, 80, 255}, {80, 160, 255, 255}, {255, 200, 60, 255}, {120, 220, 120, 255},
+    {220, 120, 255, 255}, {60, 220, 220, 255}, {255, 140, 0, 255}, {200, 200, 200, 255},
+};
+
+// Maps the layout space of one vehicle into a tile of the window
+struct TileTransform {
+    double scale;
+    int x0, y0;
+
+    explicit TileTransform(const SDL_Rect& tile)
+    {
+        scale = std::min(tile.w / (double)kLayoutW, tile.h / (double)kLayoutH);
+        x0 = tile.x + (int)((tile.w - kLayoutW * scale) / 2);
+        y0 = tile.y + (int)((tile.h - kLayoutH * scale) / 2);
+    }
+
+    // Edges are rounded (not sizes), so neighbouring rectangles stay flush
+    SDL_Rect map(int x, int y, int w, int h) const
+    {
+        int left   = (int)std::lround(x * scale);
+        int top    = (int)std::lround(y * scale);
+        int right  = (int)std::lround((x + w) * scale);
+        int bottom = (int)std::lround((y + h) * scale);
+        return {x0 + left, y0 + top, std::max(right - left, 1), bottom - top};
+    }
+};
+
+SDL_Texture* textureFromSurface(SDL_Renderer* renderer, SDL_Surface* surface)
+{
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_FreeSurface(surface);
+    if (!texture) {
+        std::cerr << "Texture Creation Error: " << SDL_GetError() << std::endl;
+    }
+    return texture;
+}
+
+void fillSurface(SDL_Surface* surface, int x, int y, int w, int h, Uint8 r, Uint8 g, Uint8 b)
+{
+    SDL_Rect rect = {x, y, w, h};
+    SDL_FillRect(surface, &rect, SDL_MapRGB(surface->format, r, g, b));
+}
+
+} // namespace
+
+Visualizer::Visualizer(const VisualizerOptions& options)
     : window(nullptr), renderer(nullptr)
 {
+    if (options.charts) {
+        telemetry = std::make_unique<SpscRing<TelemetryRecord>>(kTelemetryQueue);
+        telemetryBatch.resize(256);
+    }
+
+    if (options.offscreen) {
+        // No video subsystem, so this works without a display
+        if (SDL_Init(0) != 0) {
+            std::cerr << "SDL Initialization Error: " << SDL_GetError() << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        surface = SDL_CreateRGBSurfaceWithFormat(0, std::max(options.width, 1), std::max(options.height, 1),
+                                                 32, SDL_PIXELFORMAT_ARGB8888);
+        if (surface) {
+            renderer = SDL_CreateSoftwareRenderer(surface);
+        }
+        if (!renderer) {
+            std::cerr << "Offscreen Renderer Creation Error: " << SDL_GetError() << std::endl;
+            if (surface) SDL_FreeSurface(surface);
+            SDL_Quit();
+            exit(EXIT_FAILURE);
+        }
+        createTextures();
+        return;
+    }
+
     if (SDL_Init(SDL_INIT_VIDEO) != 0) {
         std::cerr << "SDL Initialization Error: " << SDL_GetError() << std::endl;
         exit(EXIT_FAILURE);
@@ -14,150 +115,352 @@ Visualizer::Visualizer()
     window = SDL_CreateWindow("Traction Control Simulation",
                               SDL_WINDOWPOS_CENTERED,
                               SDL_WINDOWPOS_CENTERED,
-                              800, 600,
-                              SDL_WINDOW_SHOWN);
+                              options.width, options.height,
+                              SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
     if (!window) {
         std::cerr << "Window Creation Error: " << SDL_GetError() << std::endl;
         SDL_Quit();
         exit(EXIT_FAILURE);
     }
 
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    Uint32 flags = SDL_RENDERER_ACCELERATED | (options.vsync ? SDL_RENDERER_PRESENTVSYNC : 0);
+    renderer = SDL_CreateRenderer(window, -1, flags);
     if (!renderer) {
         std::cerr << "Renderer Creation Error: " << SDL_GetError() << std::endl;
         SDL_DestroyWindow(window);
         SDL_Quit();
         exit(EXIT_FAILURE);
     }
+
+    // The driver may ignore the request
+    SDL_RendererInfo info;
+    vsync = SDL_GetRendererInfo(renderer, &info) == 0 && (info.flags & SDL_RENDERER_PRESENTVSYNC);
+
+    createTextures();
 }
 
 Visualizer::~Visualizer()
 {
+    slipChart.reset();
+    torqueChart.reset();
+    speedChart.reset();
+    if (carTexture) SDL_DestroyTexture(carTexture);
+    if (wheelTexture) SDL_DestroyTexture(wheelTexture);
     SDL_DestroyRenderer(renderer);
-    SDL_DestroyWindow(window);
+    if (window) SDL_DestroyWindow(window);
+    if (surface) SDL_FreeSurface(surface);
     SDL_Quit();
 }
 
-bool Visualizer::isRunning() const
+void Visualizer::createTextures()
+{
+    // Drawn once into surfaces; unlike render targets these survive a
+    // device reset
+    SDL_Surface* car = SDL_CreateRGBSurfaceWithFormat(0, kCarW, kCarH, 32, SDL_PIXELFORMAT_RGBA8888);
+    if (car) {
+        fillSurface(car, 0, 0, kCarW, kCarH, 200, 200, 200);              // body
+        fillSurface(car, 10, 40, kCarW - 20, 30, 90, 110, 130);           // windshield
+        fillSurface(car, 14, 75, kCarW - 28, 75, 180, 180, 180);          // roof
+        fillSurface(car, 14, kCarH - 40, kCarW - 28, 20, 90, 110, 130);   // rear window
+        carTexture = textureFromSurface(renderer, car);
+    }
+
+    // One groove per kTreadPeriod rows plus a spare period, so any scroll
+    // offset leaves a full wheel height to copy from
+    SDL_Surface* wheel = SDL_CreateRGBSurfaceWithFormat(0, kWheelW, kWheelH + kTreadPeriod, 32,
+                                                        SDL_PIXELFORMAT_RGBA8888);
+    if (wheel) {
+        fillSurface(wheel, 0, 0, kWheelW, kWheelH + kTreadPeriod, 255, 255, 255);
+        for (int y = 0; y < kWheelH + kTreadPeriod; y += kTreadPeriod) {
+            fillSurface(wheel, 0, y, kWheelW, 2, 110, 110, 110);
+        }
+        wheelTexture = textureFromSurface(renderer, wheel);
+    }
+}
+
+bool Visualizer::isRunning()
 {
+    if (isOffscreen()) return true;
+
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
         if (event.type == SDL_QUIT) {
             return false;
         }
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_p) {
+            reportRequested = true;
+        }
     }
     return true;
 }
 
-void Visualizer::render(const Vehicle& vehicle)
+void Visualizer::getOutputSize(int& width, int& height) const
+{
+    width  = kLayoutW;
+    height = kLayoutH;
+    SDL_GetRendererOutputSize(renderer, &width, &height);
+}
+
+bool Visualizer::render(const Vehicle& vehicle)
+{
+    return renderAll(&vehicle, 1);
+}
+
+bool Visualizer::render(const std::vector<Vehicle>& vehicles)
+{
+    return renderAll(vehicles.data(), (int)vehicles.size());
+}
+
+bool Visualizer::renderAll(const Vehicle* vehicles, int count)
 {
+    // Even on skipped frames, so the queue does not fill up
+    if (telemetry && count > 0) {
+        updateCharts(vehicles[0]);
+    }
+
+    if (frameCounter++ % (frameSkip + 1) != 0) {
+        return false;
+    }
+
+    speedBars.clear();
+    wheelSpeedBars.clear();
+    slipBars.clear();
+    cars.clear();
+    wheels.clear();
+
+    // Near-square grid of tiles, one vehicle each, above the charts
+    int outW, outH;
+    getOutputSize(outW, outH);
+    SDL_Rect chartArea = {0, outH, outW, 0};
+    if (telemetry) {
+        chartArea.h = outH * 2 / 5;
+        chartArea.y = outH - chartArea.h;
+    }
+    int tilesH = chartArea.y;
+    int cols = std::max(1, (int)std::ceil(std::sqrt((double)count)));
+    int rows = std::max(1, (count + cols - 1) / cols);
+    for (int v = 0; v < count; v++) {
+        SDL_Rect tile = {outW * (v % cols) / cols, tilesH * (v / cols) / rows, outW / cols, tilesH / rows};
+        addCarAndWheels(vehicles[v], tile);
+        addBarGraphs(vehicles[v], tile);
+    }
+
     // Clear to black
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderClear(renderer);
 
-    drawCarAndWheels(vehicle);
-    drawBarGraphs(vehicle);
+    drawSprites(carTexture, cars);
+    drawSprites(wheelTexture, wheels);
+    fillRects(speedBars, 0, 255, 0);
+    fillRects(wheelSpeedBars, 0, 0, 255);
+    fillRects(slipBars, 255, 0, 0);
+    if (telemetry) {
+        drawCharts(chartArea);
+    }
+
+    // The back buffer is undefined after presenting, so read it back first
+    if (recorder) {
+        captureFrame(outW, outH);
+    }
 
     SDL_RenderPresent(renderer);
+    return true;
 }
 
-void Visualizer::drawCarAndWheels(const Vehicle& vehicle)
+void Visualizer::captureFrame(int outW, int outH)
 {
-    // Draw a simple top‐down rectangle for the car, with 4 wheels at corners
-    // For brevity, we’ll assume 4 wheels. If you have more, you can adapt.
+    uint8_t* pixels = recorder->acquireFrame();
+    if (!pixels) return;  // dropped, the writer is behind
 
-    const int carX = 400;  // center of screen
-    const int carY = 300;
-    const int carW = 120;  // car body width
-    const int carH = 200;  // car body height
+    const int w = recorder->getWidth();
+    const int h = recorder->getHeight();
+    if (outW != w || outH != h) {
+        std::memset(pixels, 0, (std::size_t)w * h * 3);
+    }
+    SDL_Rect area = {0, 0, std::min(w, outW), std::min(h, outH)};
+    if (SDL_RenderReadPixels(renderer, &area, SDL_PIXELFORMAT_RGB24, pixels, w * 3) != 0) {
+        std::cerr << "Frame Capture Error: " << SDL_GetError() << std::endl;
+        return;  // the buffer is reused for the next frame
+    }
+    recorder->submitFrame();
+}
 
-    // Draw car body (white)
-    SDL_SetRenderDrawColor(renderer, 200, 200, 200, 255);
-    SDL_Rect carRect = {carX - carW/2, carY - carH/2, carW, carH};
-    SDL_RenderFillRect(renderer, &carRect);
+void Visualizer::updateCharts(const Vehicle& charted)
+{
+    std::size_t n;
+    while ((n = telemetry->pop(telemetryBatch.data(), telemetryBatch.size())) > 0) {
+        for (std::size_t k = 0; k < n; k++) {
+            const TelemetryRecord& r = telemetryBatch[k];
+            const int wheels = r.numWheels;
 
-    const auto& wheels = vehicle.getWheels();
-    if (wheels.size() < 4) return; // skip if not exactly 4 wheels
+            // Created with the first record, once the wheel count is known
+            if (!slipChart) {
+                slipChart   = std::make_unique<StripChart>(renderer, kChartColumns, kChartHeight, wheels,
+                                                           -0.25, 0.25, true);
+                torqueChart = std::make_unique<StripChart>(renderer, kChartColumns, kChartHeight, 2 * wheels,
+                                                           -200.0, 200.0, true);
+                speedChart  = std::make_unique<StripChart>(renderer, kChartColumns, kChartHeight, wheels + 1,
+                                                           0.0, 30.0, false);
+                for (int i = 0; i < wheels; i++) {
+                    const SDL_Color& c = kWheelColors[i];
+                    slipChart->setTraceColor(i, c.r, c.g, c.b);
+                    torqueChart->setTraceColor(2 * i, c.r, c.g, c.b);
+                    torqueChart->setTraceColor(2 * i + 1, c.r / 2, c.g / 2, c.b / 2);
+                    speedChart->setTraceColor(i + 1, c.r, c.g, c.b);
+                }
+                speedChart->setTraceColor(0, 0, 255, 0);  // the vehicle, green like its bar
+            }
 
-    // We'll place wheels at corners of that rectangle
-    // front-left, front-right, rear-left, rear-right
-    // Then rotate them according to w.rotationAngle.
+            float torques[2 * TelemetryRecord::kMaxWheels] = {};
+            float speeds[TelemetryRecord::kMaxWheels + 1] = {};
+            speeds[0] = r.linearSpeed;
+            for (int i = 0; i < wheels; i++) {
+                torques[2 * i]     = r.driveTorque[i];
+                torques[2 * i + 1] = -r.brakeTorque[i];  // braking plots below zero
+                speeds[i + 1]      = r.wheelSpeed[i] * (float)charted.wheelRadius;
+            }
 
-    // For demonstration, let's define offsets from the center:
-    struct WheelPos {
-        int dx, dy; // offsets from car center
-    };
-    WheelPos wheelOffsets[4] = {
-        {-carW/2 - 10, -carH/2 + 20}, // front-left
-        { carW/2 + 10, -carH/2 + 20}, // front-right
-        {-carW/2 - 10,  carH/2 - 20}, // rear-left
-        { carW/2 + 10,  carH/2 - 20}, // rear-right
-    };
+            long long column = (long long)std::floor(r.time / kChartColumnSeconds + 1e-6);
+            slipChart->addSample(column, r.slip);
+            torqueChart->addSample(column, torques);
+            speedChart->addSample(column, speeds);
+        }
+    }
+}
 
-    // Wheel dimension
-    const int wWidth = 12;
-    const int wHeight = 30;
+void Visualizer::drawCharts(const SDL_Rect& area)
+{
+    if (!slipChart) return;
 
-    // For each wheel, we'll rotate a small rectangle in place
-    for (int i = 0; i < 4; i++) {
-        double angleRad = wheels[i].rotationAngle;
+    // Slip, torques and speeds stacked top to bottom
+    StripChart* charts[] = {slipChart.get(), torqueChart.get(), speedChart.get()};
+    const int pitch = area.h / 3;
+    for (int i = 0; i < 3; i++) {
+        SDL_Rect dst = {area.x, area.y + i * pitch + kChartGap, area.w, std::max(pitch - kChartGap, 1)};
+        charts[i]->draw(dst);
+    }
+}
+
+void Visualizer::addCarAndWheels(const Vehicle& vehicle, const SDL_Rect& tile)
+{
+    // A simple top-down car with its wheels along the sides
+    const TileTransform t(tile);
+    const int carX = kLayoutW / 2;  // center of the tile
+    const int carY = kLayoutH / 2;
 
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    cars.push_back({{0, 0, kCarW, kCarH}, t.map(carX - kCarW/2, carY - kCarH/2, kCarW, kCarH)});
 
-        // Compute wheel center
-        int wxCenter = carX + wheelOffsets[i].dx;
-        int wyCenter = carY + wheelOffsets[i].dy;
+    const auto& vehicleWheels = vehicle.getWheels();
+    const int numWheels = (int)vehicleWheels.size();
+    if (numWheels == 0) return;
 
-        SDL_Rect wheelRect = {
-            wxCenter - wWidth/2,
-            wyCenter - wHeight/2,
-            wWidth,
-            wHeight
-        };
-        SDL_RenderFillRect(renderer, &wheelRect);
+    // Wheels come in left/right pairs, one pair per axle, from front to rear:
+    // 0 = front-left, 1 = front-right, 2 = next axle left, ...
+    // With an odd count the last wheel sits alone on the rear center line.
+    const int numAxles = (numWheels + 1) / 2;
+    const int frontY = -kCarH/2 + 20;
+    const int rearY  =  kCarH/2 - 20;
 
+    // Many axles shrink the wheels so they do not overlap
+    int wheelH = kWheelH;
+    if (numAxles > 1) {
+        wheelH = std::min(kWheelH, (rearY - frontY) * 4 / (5 * (numAxles - 1)));
+    }
+
+    for (int i = 0; i < numWheels; i++) {
+        int axle = i / 2;
+        int dy = (numAxles > 1) ? frontY + (rearY - frontY) * axle / (numAxles - 1) : 0;
+        int dx;
+        if (numWheels % 2 == 1 && i == numWheels - 1) {
+            dx = 0;
+        } else {
+            dx = (i % 2 == 0) ? -kCarW/2 - 10 : kCarW/2 + 10;
+        }
+
+        // The tread scrolls with rotationAngle, kGroovesPerRevolution per turn
+        double turns = vehicleWheels[i].rotationAngle / (2.0 * M_PI);
+        double phase = turns * kGroovesPerRevolution;
+        int offset = (int)((phase - std::floor(phase)) * kTreadPeriod) % kTreadPeriod;
+
+        SDL_Rect src = {0, offset, kWheelW, kWheelH};
+        wheels.push_back({src, t.map(carX + dx - kWheelW/2, carY + dy - wheelH/2, kWheelW, wheelH)});
     }
 }
 
-void Visualizer::drawBarGraphs(const Vehicle& vehicle)
+void Visualizer::addBarGraphs(const Vehicle& vehicle, const SDL_Rect& tile)
 {
+    const TileTransform t(tile);
+
     // --- Green bar (vehicle linear speed) ---
     double linSpeed = vehicle.getLinearSpeed();
     int greenHeight = static_cast<int>(linSpeed * 5.0);
     if (greenHeight > 500) greenHeight = 500;
+    if (greenHeight > 0) {
+        speedBars.push_back(t.map(50, 550 - greenHeight, 30, greenHeight));
+    }
 
-    SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-    SDL_Rect speedRect = { 50, 550 - greenHeight, 30, greenHeight };
-    SDL_RenderFillRect(renderer, &speedRect);
+    const int numWheels = (int)vehicle.getWheels().size();
+    if (numWheels == 0) return;
+    const int pitch = std::min(kMaxBarPitch, kBarsWidth / numWheels);
+    const int width = std::max(1, pitch * 2 / 3);
 
-    // --- Blue bars (each wheel speed) ---
-    SDL_SetRenderDrawColor(renderer, 0, 0, 255, 255);
-    int xOffset = 100;
-    for (int i = 0; i < (int)vehicle.getWheels().size(); i++) {
+    for (int i = 0; i < numWheels; i++) {
+        // --- Blue bars (each wheel speed) ---
         double wSpeed = vehicle.getWheels()[i].angularVelocity * vehicle.wheelRadius;
         int barHeight = static_cast<int>(wSpeed * 5.0);
-        if (barHeight < 0)   barHeight = 0;
         if (barHeight > 500) barHeight = 500;
+        if (barHeight > 0) {
+            wheelSpeedBars.push_back(t.map(kWheelBarsX + i * pitch, 550 - barHeight, width, barHeight));
+        }
 
-        SDL_Rect wheelRect = { xOffset, 550 - barHeight, 20, barHeight };
-        SDL_RenderFillRect(renderer, &wheelRect);
-
-        xOffset += 30;
+        // --- Red bars (slip ratio) on the right side ---
+        double slipPixels = 100.0 * std::fabs(vehicle.computeSlipRatio(i));
+        if (slipPixels > 200) slipPixels = 200;
+        int slipHeight = static_cast<int>(slipPixels);
+        if (slipHeight > 0) {
+            slipBars.push_back(t.map(kSlipBarsX + i * pitch, 550 - slipHeight, width, slipHeight));
+        }
     }
+}
 
-    // --- Red bars (slip ratio) - moved to the right side, e.g. ~x=700 ---
-    SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
+void Visualizer::fillRects(const std::vector<SDL_Rect>& rects, Uint8 r, Uint8 g, Uint8 b)
+{
+    if (rects.empty()) return;
+    SDL_SetRenderDrawColor(renderer, r, g, b, 255);
+    SDL_RenderFillRects(renderer, rects.data(), (int)rects.size());
+}
 
-    int slipX = 700;  
-    for (int i = 0; i < (int)vehicle.getWheels().size(); i++) {
-        double slip = vehicle.computeSlipRatio(i);
-        double slipPixels = 100.0 * std::fabs(slip);
-        if (slipPixels > 200) slipPixels = 200;
+void Visualizer::drawSprites(SDL_Texture* texture, const std::vector<Sprite>& sprites)
+{
+    if (!texture || sprites.empty()) return;
 
-        int barHeight = static_cast<int>(slipPixels);
-        SDL_Rect slipRect = { slipX, 550 - barHeight, 20, barHeight };
-        SDL_RenderFillRect(renderer, &slipRect);
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    // All sprites of a texture as one indexed triangle list
+    int texW = 0, texH = 0;
+    SDL_QueryTexture(texture, nullptr, nullptr, &texW, &texH);
+    vertices.clear();
+    indices.clear();
+    const SDL_Color white = {255, 255, 255, 255};
+    for (const Sprite& s : sprites) {
+        float x0 = (float)s.dst.x, x1 = (float)(s.dst.x + s.dst.w);
+        float y0 = (float)s.dst.y, y1 = (float)(s.dst.y + s.dst.h);
+        float u0 = (float)s.src.x / texW, u1 = (float)(s.src.x + s.src.w) / texW;
+        float v0 = (float)s.src.y / texH, v1 = (float)(s.src.y + s.src.h) / texH;
 
-        slipX += 30;
+        int base = (int)vertices.size();
+        vertices.push_back({{x0, y0}, white, {u0, v0}});
+        vertices.push_back({{x1, y0}, white, {u1, v0}});
+        vertices.push_back({{x1, y1}, white, {u1, v1}});
+        vertices.push_back({{x0, y1}, white, {u0, v1}});
+        for (int k : {0, 1, 2, 0, 2, 3}) {
+            indices.push_back(base + k);
+        }
     }
-}
\ No newline at end of file
+    SDL_RenderGeometry(renderer, texture, vertices.data(), (int)vertices.size(),
+                       indices.data(), (int)indices.size());
+#else
+    for (const Sprite& s : sprites) {
+        SDL_RenderCopy(renderer, texture, &s.src, &s.dst);
+    }
+#endif
+}
@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "BatchSimulation.h"
+#include "Snapshot.h"
+
+// Evenly spaced values in [lo, hi].
+static std::vector<double> linspace(double lo, double hi, int count)
+{
+    std::vector<double> values;
+    for (int i = 0; i < count; i++) {
+        values.push_back(count > 1 ? lo + (hi - lo) * i / (count - 1) : lo);
+    }
+    return values;
+}
+
+// Drives a reference vehicle (15 m/s, dry road) for `seconds` and snapshots it
+static bool warmUp(double seconds, std::shared_ptr<const FrictionTable> table, SimulationSnapshot& out)
+{
+    const double dt = 0.01;
+    Vehicle vehicle(15.0, 4);
+    TractionControl tc(0.1);
+    vehicle.setTireModel(std::move(table));
+
+    int steps = (int)std::lround(seconds / dt);
+    for (int step = 0; step < steps; step++) {
+        tc.update(vehicle, dt);
+        vehicle.update(dt);
+    }
+    return captureSnapshot(vehicle, tc, steps * dt, out);
+}
+
+int main(int argc, char* argv[])
+{
+    int threads   = 0;    // 0 => all hardware threads
+    unsigned long long seed = 0;
+    int gridSize  = 20;   // values per swept parameter
+    int steps     = 1000; // 10 s at 100 Hz
+    double noise  = 0.0;
+    std::string tire;     // empty => exact exponential model
+    std::string surface;  // empty => uniform road
+    std::string surfaceOut;
+    double branchAt = -1.0;  // >= 0 => branch from a warmed-up snapshot
+    std::string snapshotIn;
+    std::string snapshotOut;
+    double dt     = 0.01;
+    Vehicle::Integrator integrator = Vehicle::Integrator::Euler;
+    double tolerance = 0.0;  // rad/s, 0 => fixed step
+    std::string worstOut;
+    int worstCount = 10;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--grid" && i + 1 < argc) {
+            gridSize = std::atoi(argv[++i]);
+        } else if (arg == "--steps" && i + 1 < argc) {
+            steps = std::atoi(argv[++i]);
+        } else if (arg == "--noise" && i + 1 < argc) {
+            noise = std::atof(argv[++i]);
+        } else if (arg == "--tire" && i + 1 < argc) {
+            tire = argv[++i];
+        } else if (arg == "--surface" && i + 1 < argc) {
+            surface = argv[++i];
+        } else if (arg == "--save-surface" && i + 1 < argc) {
+            surfaceOut = argv[++i];
+        } else if (arg == "--branch-at" && i + 1 < argc) {
+            branchAt = std::atof(argv[++i]);
+        } else if (arg == "--snapshot" && i + 1 < argc) {
+            snapshotIn = argv[++i];
+        } else if (arg == "--save-snapshot" && i + 1 < argc) {
+            snapshotOut = argv[++i];
+        } else if (arg == "--dt" && i + 1 < argc) {
+            dt = std::atof(argv[++i]);
+        } else if (arg == "--integrator" && i + 1 < argc && Vehicle::parseIntegrator(argv[i + 1], integrator)) {
+            i++;
+        } else if (arg == "--tolerance" && i + 1 < argc) {
+            tolerance = std::atof(argv[++i]);
+        } else if (arg == "--save-worst" && i + 1 < argc) {
+            worstOut = argv[++i];
+        } else if (arg == "--worst" && i + 1 < argc) {
+            worstCount = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--threads N] [--seed S] [--grid N] [--steps N] [--noise SIGMA]"
+                      << " [--tire exponential|pacejka|FILE] [--surface ice|wet|split|FILE] [--save-surface FILE]"
+                      << " [--branch-at SECONDS | --snapshot FILE] [--save-snapshot FILE]"
+                      << " [--dt SECONDS] [--integrator euler|semi-implicit|rk4|implicit] [--tolerance RAD_S]"
+                      << " [--save-worst FILE [--worst N]]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::shared_ptr<const FrictionTable> table;
+    if (!tire.empty()) {
+        auto model = TireModel::create(tire);
+        if (!model) return EXIT_FAILURE;
+        table = std::make_shared<FrictionTable>(*model);
+    }
+
+    std::shared_ptr<const SurfaceProfile> road;
+    if (!surface.empty()) {
+        auto profile = SurfaceProfile::create(surface);
+        if (!profile) return EXIT_FAILURE;
+        if (!surfaceOut.empty() && !profile->save(surfaceOut)) return EXIT_FAILURE;
+        road = profile;
+    } else if (!surfaceOut.empty()) {
+        std::cerr << "--save-surface needs --surface" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Branch point: the first snapshot of a file, or a warmed-up reference run
+    bool branching = branchAt >= 0.0 || !snapshotIn.empty();
+    if (!snapshotOut.empty() && !branching) {
+        std::cerr << "--save-snapshot needs --branch-at or --snapshot" << std::endl;
+        return EXIT_FAILURE;
+    }
+    SimulationSnapshot start{};
+    if (!snapshotIn.empty()) {
+        std::vector<SimulationSnapshot> loaded;
+        if (!loadSnapshots(snapshotIn, loaded)) return EXIT_FAILURE;
+        if (loaded.empty()) {
+            std::cerr << "No snapshots in " << snapshotIn << std::endl;
+            return EXIT_FAILURE;
+        }
+        start = loaded.front();
+    } else if (branching && !warmUp(branchAt, table, start)) {
+        return EXIT_FAILURE;
+    }
+    if (!snapshotOut.empty() && !saveSnapshots(snapshotOut, &start, 1)) {
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Scenario> scenarios;
+    if (branching) {
+        // What-if sweep from the branch point: road friction x friction noise
+        for (double mu : linspace(0.1, 1.0, gridSize)) {
+            for (double sigma : linspace(0.0, 0.2, gridSize)) {
+                Scenario s;
+                s.friction      = mu;
+                s.frictionNoise = sigma;
+                s.steps         = steps;
+                scenarios.push_back(s);
+            }
+        }
+    } else {
+        // Sweep road friction, initial speed and desired slip
+        scenarios = BatchSimulation::makeGrid(linspace(0.3, 1.0, gridSize),
+                                              linspace(5.0, 25.0, gridSize),
+                                              linspace(0.05, 0.15, gridSize),
+                                              steps);
+        for (auto& s : scenarios) {
+            s.frictionNoise = noise;
+        }
+    }
+
+    if (!(dt > 0.0)) {
+        std::cerr << "--dt must be positive" << std::endl;
+        return EXIT_FAILURE;
+    }
+    for (auto& s : scenarios) {
+        s.surface = road;
+        s.integrator = integrator;
+        s.integratorTolerance = tolerance;
+    }
+
+    BatchSimulation batch(threads, seed, dt);
+    batch.setTireModel(table);
+    auto results = branching ? batch.run(scenarios, SnapshotArena::repeat(start, scenarios.size()))
+                             : batch.run(scenarios);
+
+    double worstError = 0.0;
+    double meanError  = 0.0;
+    for (const auto& r : results) {
+        meanError += r.meanSlipError;
+        worstError = std::max(worstError, r.meanSlipError);
+    }
+    if (!results.empty()) meanError /= results.size();
+
+    const auto& stats = batch.lastStats();
+    std::cout << "Scenarios: " << stats.scenarios
+              << " | threads: " << stats.threads
+              << " | time: " << stats.seconds << " s"
+              << " | " << stats.scenariosPerSecond << " scenarios/s" << std::endl;
+    if (branching) {
+        std::cout << "Branched at t = " << start.time << " s, speed " << start.linearSpeed
+                  << " m/s" << std::endl;
+    }
+    std::cout << "Mean slip error: " << meanError
+              << " | worst scenario: " << worstError << std::endl;
+
+    // Start states of the worst scenarios, for traction_control --snapshot
+    // (a replay matches the batch only on a uniform road at dt = 0.01)
+    if (!worstOut.empty()) {
+        std::vector<std::size_t> order(results.size());
+        for (std::size_t i = 0; i < order.size(); i++) order[i] = i;
+        std::size_t count = std::min<std::size_t>(worstCount, order.size());
+        std::partial_sort(order.begin(), order.begin() + count, order.end(),
+                          [&](std::size_t a, std::size_t b) {
+                              return results[a].meanSlipError > results[b].meanSlipError;
+                          });
+
+        std::vector<SimulationSnapshot> worst(count);
+        for (std::size_t k = 0; k < count; k++) {
+            const Scenario& s = scenarios[order[k]];
+            Vehicle vehicle = branching ? restoreVehicle(start) : Vehicle(s.initialSpeed, s.numWheels);
+            TractionControl tc = branching ? restoreController(start) : TractionControl(s.desiredSlip, s.gains);
+            vehicle.setFriction(s.friction);
+            if (!captureSnapshot(vehicle, tc, branching ? start.time : 0.0, worst[k])) {
+                std::cerr << "Too many wheels for a snapshot" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        if (!saveSnapshots(worstOut, worst.data(), worst.size())) return EXIT_FAILURE;
+        std::cout << "Saved the " << count << " worst scenarios to " << worstOut << std::endl;
+    }
+
+    return 0;
+}
@@ -1,18 +1,186 @@
 #include <SDL2/SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
 #include <memory>
+#include <string>
+#include <vector>
 #include "Vehicle.h"
 #include "TractionControl.h"
 #include "Visualizer.h"
 #include "Simulation.h"
+#include "Snapshot.h"
+#include "FrameRecorder.h"
+#include "FlightRecorder.h"
 
 int main(int argc, char* argv[])
 {
-    auto vehicle = std::make_shared<Vehicle>(5.0, 4);
-    auto tc = std::make_shared<TractionControl>(0.1);
-    auto vis = std::make_shared<Visualizer>();
+    SimulationOptions options;
+    bool headless = false;
+    int frameSkip = 0;
+    int numWheels = 4;
+    int numVehicles = 1;
+    bool vsync = true;
+    bool offscreen = false;
+    bool charts = false;
+    std::string recordPath;
+    std::string snapshotIn;
+    std::string flightPath;
+    FlightRecorderOptions flightOptions;
+    std::string tire;  // empty => exact exponential model
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--speed" && i + 1 < argc) {
+            char* end;
+            options.timeScale = std::strtod(argv[++i], &end);  // 1, 10, 100, ...
+            if (*end != '\0' || !std::isfinite(options.timeScale) || options.timeScale <= 0.0) {
+                std::cerr << "--speed needs a positive number (use --max to run unpaced)" << std::endl;
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--max") {
+            options.timeScale = 0.0;                    // as fast as possible
+        } else if (arg == "--headless") {
+            headless = true;
+        } else if (arg == "--duration" && i + 1 < argc) {
+            options.duration = std::atof(argv[++i]);    // simulated seconds
+        } else if (arg == "--frame-skip" && i + 1 < argc) {
+            frameSkip = std::atoi(argv[++i]);
+        } else if (arg == "--wheels" && i + 1 < argc) {
+            numWheels = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--vehicles" && i + 1 < argc) {
+            numVehicles = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--no-vsync") {
+            vsync = false;
+        } else if (arg == "--charts") {
+            charts = true;
+        } else if (arg == "--offscreen") {
+            offscreen = true;
+        } else if (arg == "--record" && i + 1 < argc) {
+            recordPath = argv[++i];                     // run.y4m or run.png
+        } else if (arg == "--fps" && i + 1 < argc) {
+            options.frameRate = std::atof(argv[++i]);   // offscreen frames per simulated second
+        } else if (arg == "--snapshot" && i + 1 < argc) {
+            snapshotIn = argv[++i];                     // e.g. from batch_simulation --save-worst
+        } else if (arg == "--flight-recorder" && i + 1 < argc) {
+            flightPath = argv[++i];                     // run.tcfr
+        } else if (arg == "--dump-seconds" && i + 1 < argc) {
+            flightOptions.dumpSeconds = std::atof(argv[++i]);
+        } else if (arg == "--slip-trigger" && i + 1 < argc) {
+            flightOptions.slipTrigger = std::atof(argv[++i]);  // |slip| that saves a dump
+        } else if (arg == "--tire" && i + 1 < argc) {
+            tire = argv[++i];                           // exponential, pacejka or a table file
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--speed X | --max] [--headless] [--duration SECONDS] [--frame-skip N] [--wheels N]"
+                      << " [--vehicles N] [--no-vsync] [--tire exponential|pacejka|FILE]"
+                      << " [--charts] [--offscreen] [--record FILE.y4m|FILE.png] [--fps N] [--snapshot FILE]"
+                      << " [--flight-recorder FILE.tcfr [--dump-seconds S] [--slip-trigger SLIP]]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (headless && (offscreen || !recordPath.empty())) {
+        std::cerr << "--offscreen and --record need rendering, not --headless" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Without a window nothing else would end the run
+    if ((headless || offscreen) && options.duration <= 0.0) {
+        options.duration = 60.0;
+    }
+
+    std::shared_ptr<const FrictionTable> table;
+    if (!tire.empty()) {
+        auto model = TireModel::create(tire);
+        if (!model) return EXIT_FAILURE;
+        table = std::make_shared<FrictionTable>(*model);
+    }
+
+    // A fleet spreads the road friction from dry (1.0) down to icy (0.2);
+    // a snapshot file replays one vehicle per snapshot instead
+    std::vector<std::shared_ptr<Vehicle>> vehicles;
+    std::vector<std::shared_ptr<TractionControl>> controllers;
+    std::vector<SimulationSnapshot> starts;
+    if (!snapshotIn.empty()) {
+        if (!loadSnapshots(snapshotIn, starts)) return EXIT_FAILURE;
+        if (starts.empty()) {
+            std::cerr << "No snapshots in " << snapshotIn << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    for (const auto& start : starts) {
+        auto vehicle = std::make_shared<Vehicle>(restoreVehicle(start));
+        vehicle->setTireModel(table);
+        vehicles.push_back(vehicle);
+        controllers.push_back(std::make_shared<TractionControl>(restoreController(start)));
+    }
+    for (int v = 0; starts.empty() && v < numVehicles; v++) {
+        auto vehicle = std::make_shared<Vehicle>(5.0, numWheels);
+        vehicle->setTireModel(table);
+        if (numVehicles > 1) {
+            vehicle->setFriction(1.0 - 0.8 * v / (numVehicles - 1));
+        }
+        vehicles.push_back(vehicle);
+        controllers.push_back(std::make_shared<TractionControl>(0.1));
+    }
+
+    std::shared_ptr<Visualizer> vis;
+    if (!headless) {
+        VisualizerOptions visOptions;
+        visOptions.vsync = vsync;
+        visOptions.offscreen = offscreen;
+        visOptions.charts = charts;
+        if (charts) {
+            visOptions.height = 1000;  // the tiles keep their 600 rows
+        }
+        vis = std::make_shared<Visualizer>(visOptions);
+        vis->setFrameSkip(frameSkip);
+    }
+
+    Simulation sim(vehicles, controllers, vis, options);
+
+    // Frames are encoded on the recorder's thread. Offscreen rendering waits
+    // for it, so no frame is lost; a live window drops frames instead of
+    // stalling the display.
+    std::shared_ptr<FrameRecorder> recorder;
+    if (!recordPath.empty()) {
+        FrameRecorderOptions recOptions;
+        recOptions.fps = offscreen ? std::max(1, (int)std::lround(sim.getOffscreenFrameRate())) : 60;
+        recOptions.dropWhenFull = !offscreen;
+        int width, height;
+        vis->getOutputSize(width, height);
+        recorder = std::make_shared<FrameRecorder>();
+        if (!recorder->open(recordPath, width, height, recOptions)) return EXIT_FAILURE;
+        vis->setRecorder(recorder);
+    }
+
+    std::shared_ptr<FlightRecorder> flight;
+    if (!flightPath.empty()) {
+        flight = std::make_shared<FlightRecorder>();
+        if (!flight->open(flightPath, Simulation::kPhysicsDt, (int)vehicles.size(), flightOptions)) {
+            return EXIT_FAILURE;
+        }
+        sim.setFlightRecorder(flight);
+    }
 
-    Simulation sim(vehicle, tc, vis);
     sim.run();
 
+    if (flight) {
+        bool ok = flight->close();
+        std::cout << "Flight recorder: " << flight->recordsWritten() << " records, "
+                  << flight->recordsDropped() << " dropped, " << flight->dumpsWritten() << " dumps" << std::endl;
+        if (!ok) return EXIT_FAILURE;
+    }
+
+    if (recorder) {
+        vis->setRecorder(nullptr);
+        bool ok = recorder->close();
+        std::cout << "Recorded " << recorder->framesWritten() << " frames to " << recordPath
+                  << " (" << recorder->framesDropped() << " dropped)" << std::endl;
+        if (!ok) return EXIT_FAILURE;
+    }
+
     return 0;
 }
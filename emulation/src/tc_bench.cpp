@@ -0,0 +1,505 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Vehicle.h"
+#include "VehicleFleet.h"
+#include "TractionControl.h"
+#include "FixedTractionControl.h"
+#include "FleetTractionControl.h"
+#include "DataGenerator.h"
+#include "TraceWriter.h"
+#include "TireModel.h"
+#include "SurfaceProfile.h"
+#include "BatchSimulation.h"
+#include "FlightRecorder.h"
+
+// Micro and macro benchmarks for the simulation core.
+//
+// JSON for regression tracking:
+//   ./tc_bench --benchmark_format=json > bench.json
+//   ./tc_bench --benchmark_out=bench.json --benchmark_out_format=json
+
+namespace {
+
+const double kDt = 0.01;
+
+// Discards every record, so generateData is measured without disk I/O.
+class NullTraceSink : public TraceSink {
+public:
+    bool open(const std::string&) override { return true; }
+    bool write(const TraceRecord* records, std::size_t) override
+    {
+        benchmark::DoNotOptimize(records);
+        return true;
+    }
+    bool close() override { return true; }
+};
+
+Vehicle makeVehicle(int numWheels)
+{
+    Vehicle vehicle(20.0, numWheels);
+    for (int i = 0; i < numWheels; i++) {
+        vehicle.setDriveTorque(i, 50.0);
+    }
+    return vehicle;
+}
+
+} // namespace
+
+static void BM_VehicleUpdate(benchmark::State& state)
+{
+    int numWheels = static_cast<int>(state.range(0));
+    Vehicle vehicle = makeVehicle(numWheels);
+
+    for (auto _ : state) {
+        vehicle.update(kDt);
+        benchmark::DoNotOptimize(vehicle.getLinearSpeed());
+    }
+    state.SetItemsProcessed(state.iterations() * numWheels);
+    state.counters["wheels"] = numWheels;
+}
+BENCHMARK(BM_VehicleUpdate)->RangeMultiplier(2)->Range(2, 64);
+
+static void BM_ComputeSlipRatio(benchmark::State& state)
+{
+    int numWheels = static_cast<int>(state.range(0));
+    Vehicle vehicle = makeVehicle(numWheels);
+    vehicle.update(kDt);
+
+    for (auto _ : state) {
+        for (int i = 0; i < numWheels; i++) {
+            benchmark::DoNotOptimize(vehicle.computeSlipRatio(i));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * numWheels);
+    state.counters["wheels"] = numWheels;
+}
+BENCHMARK(BM_ComputeSlipRatio)->RangeMultiplier(2)->Range(2, 64);
+
+static void BM_RuleBasedControl(benchmark::State& state)
+{
+    int numWheels = static_cast<int>(state.range(0));
+    Vehicle vehicle = makeVehicle(numWheels);
+    TractionControl tc(0.1);
+    vehicle.update(kDt);
+
+    for (auto _ : state) {
+        tc.update(vehicle, kDt);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * numWheels);
+    state.counters["wheels"] = numWheels;
+}
+BENCHMARK(BM_RuleBasedControl)->RangeMultiplier(2)->Range(2, 64);
+
+// Controller and physics together, as in Simulation::run
+static void BM_ControlledStep(benchmark::State& state)
+{
+    int numWheels = static_cast<int>(state.range(0));
+    Vehicle vehicle(20.0, numWheels);
+    TractionControl tc(0.1);
+
+    for (auto _ : state) {
+        tc.update(vehicle, kDt);
+        vehicle.update(kDt);
+        benchmark::DoNotOptimize(vehicle.getLinearSpeed());
+    }
+    state.SetItemsProcessed(state.iterations() * numWheels);
+    state.counters["wheels"] = numWheels;
+}
+BENCHMARK(BM_ControlledStep)->Arg(4);
+
+// Compile-time wheel count; compare with BM_VehicleUpdate / BM_ControlledStep
+template <int N>
+static void BM_FixedVehicleUpdate(benchmark::State& state)
+{
+    FixedVehicle<N> vehicle(20.0);
+    for (int i = 0; i < N; i++) {
+        vehicle.setDriveTorque(i, 50.0);
+    }
+
+    for (auto _ : state) {
+        vehicle.update(kDt);
+        benchmark::DoNotOptimize(vehicle.getLinearSpeed());
+    }
+    state.SetItemsProcessed(state.iterations() * N);
+    state.counters["wheels"] = N;
+}
+BENCHMARK_TEMPLATE(BM_FixedVehicleUpdate, 2);
+BENCHMARK_TEMPLATE(BM_FixedVehicleUpdate, 4);
+BENCHMARK_TEMPLATE(BM_FixedVehicleUpdate, 8);
+
+template <int N>
+static void BM_FixedControlledStep(benchmark::State& state)
+{
+    FixedVehicle<N> vehicle(20.0);
+    FixedTractionControl<N> tc(0.1);
+
+    for (auto _ : state) {
+        tc.update(vehicle, kDt);
+        vehicle.update(kDt);
+        benchmark::DoNotOptimize(vehicle.getLinearSpeed());
+    }
+    state.SetItemsProcessed(state.iterations() * N);
+    state.counters["wheels"] = N;
+}
+BENCHMARK_TEMPLATE(BM_FixedControlledStep, 4);
+
+static void BM_FleetUpdate(benchmark::State& state)
+{
+    int numVehicles = static_cast<int>(state.range(0));
+    VehicleFleet fleet(numVehicles, 4, 20.0);
+    for (int v = 0; v < numVehicles; v++) {
+        for (int w = 0; w < 4; w++) {
+            fleet.setDriveTorque(v, w, 50.0);
+        }
+    }
+
+    for (auto _ : state) {
+        fleet.update(kDt);
+        benchmark::DoNotOptimize(fleet.getLinearSpeed(0));
+    }
+    state.SetItemsProcessed(state.iterations() * numVehicles * 4);
+    state.SetLabel(VehicleFleet::kernelName());
+}
+BENCHMARK(BM_FleetUpdate)->RangeMultiplier(8)->Range(1, 4096);
+
+// Batched rule-based control over every wheel of a fleet; items are wheels.
+// Before timing, 500 controlled steps are checked against TractionControl on
+// scalar Vehicles (the benchmark fails if any torque differs).
+static void BM_FleetControl(benchmark::State& state)
+{
+    int numVehicles = static_cast<int>(state.range(0));
+    const int numWheels = 4;
+    VehicleFleet fleet(numVehicles, numWheels);
+    FleetTractionControl ftc(numVehicles, numWheels);
+
+    std::vector<Vehicle> vehicles;
+    std::vector<TractionControl> controllers;
+    for (int v = 0; v < numVehicles; v++) {
+        double desiredSlip = 0.05 + 0.1 * v / numVehicles;
+        vehicles.push_back(makeVehicle(numWheels));
+        vehicles.back().setFriction(0.3 + 0.7 * v / numVehicles);
+        controllers.emplace_back(desiredSlip);
+        ftc.setDesiredSlip(v, desiredSlip);
+    }
+
+    for (int step = 0; step < 500; step++) {
+        for (int v = 0; v < numVehicles; v++) {
+            fleet.loadVehicle(v, vehicles[v]);
+            controllers[v].update(vehicles[v], kDt);
+        }
+        ftc.update(fleet, kDt);
+        for (int v = 0; v < numVehicles; v++) {
+            for (int w = 0; w < numWheels; w++) {
+                const auto& wheel = vehicles[v].getWheels()[w];
+                if (wheel.brakeTorque != fleet.getBrakeTorque(v, w) ||
+                    wheel.driveTorque != fleet.getDriveTorque(v, w)) {
+                    state.SkipWithError("FleetTractionControl differs from TractionControl");
+                    return;
+                }
+            }
+            vehicles[v].update(kDt);
+        }
+    }
+
+    for (auto _ : state) {
+        ftc.update(fleet, kDt);
+        benchmark::DoNotOptimize(fleet.brakeTorqueData());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * numVehicles * numWheels);
+    state.SetLabel(VehicleFleet::kernelName());
+}
+BENCHMARK(BM_FleetControl)->RangeMultiplier(8)->Range(1, 4096);
+
+// Batched controller and fleet physics together, the batch-sweep hot loop.
+// Before timing, 1000 coupled steps are checked against TractionControl and
+// Vehicle::update on scalar Vehicles (the benchmark fails if a speed, wheel
+// velocity or rotation angle is off by more than VehicleFleet's 1e-9
+// accuracy contract).
+static void BM_FleetControlledStep(benchmark::State& state)
+{
+    int numVehicles = static_cast<int>(state.range(0));
+    const int numWheels = 4;
+    VehicleFleet fleet(numVehicles, numWheels, 20.0);
+    FleetTractionControl ftc(numVehicles, numWheels);
+
+    std::vector<Vehicle> vehicles;
+    std::vector<TractionControl> controllers;
+    for (int v = 0; v < numVehicles; v++) {
+        double desiredSlip = 0.05 + 0.1 * v / numVehicles;
+        vehicles.push_back(makeVehicle(numWheels));
+        vehicles.back().setFriction(0.3 + 0.7 * v / numVehicles);
+        controllers.emplace_back(desiredSlip);
+        ftc.setDesiredSlip(v, desiredSlip);
+        fleet.loadVehicle(v, vehicles.back());
+    }
+
+    auto agrees = [](double value, double reference) {
+        return std::fabs(value - reference) <= 1e-9 * std::max(std::fabs(reference), 1e-3);
+    };
+    for (int step = 0; step < 1000; step++) {
+        ftc.update(fleet, kDt);
+        fleet.update(kDt);
+        for (int v = 0; v < numVehicles; v++) {
+            controllers[v].update(vehicles[v], kDt);
+            vehicles[v].update(kDt);
+
+            bool ok = agrees(fleet.getLinearSpeed(v), vehicles[v].getLinearSpeed());
+            for (int w = 0; w < numWheels; w++) {
+                const auto& wheel = vehicles[v].getWheels()[w];
+                ok = ok && agrees(fleet.getAngularVelocity(v, w), wheel.angularVelocity) &&
+                     agrees(fleet.getRotationAngle(v, w), wheel.rotationAngle);
+            }
+            if (!ok) {
+                state.SkipWithError("VehicleFleet differs from Vehicle beyond 1e-9");
+                return;
+            }
+        }
+    }
+
+    for (auto _ : state) {
+        ftc.update(fleet, kDt);
+        fleet.update(kDt);
+        benchmark::DoNotOptimize(fleet.getLinearSpeed(0));
+    }
+    state.SetItemsProcessed(state.iterations() * numVehicles * 4);
+    state.SetLabel(VehicleFleet::kernelName());
+}
+BENCHMARK(BM_FleetControlledStep)->RangeMultiplier(8)->Range(1, 4096);
+
+// Friction coefficient per wheel: the exponential evaluated directly
+// against a FrictionTable, scalar and batched (AVX2 gathers)
+// Arg 0: std::exp, 1: table lookup, 2: batched table lookup
+static void BM_FrictionCurve(benchmark::State& state)
+{
+    const int count = 1024;
+    std::vector<double> slips(count), mu(count);
+    for (int i = 0; i < count; i++) {
+        slips[i] = 0.6 * i / count;
+    }
+    ExponentialTireModel model;
+    FrictionTable table(model);
+
+    for (auto _ : state) {
+        switch (state.range(0)) {
+            case 0:
+                for (int i = 0; i < count; i++) mu[i] = model.evaluate(slips[i]);
+                break;
+            case 1:
+                for (int i = 0; i < count; i++) mu[i] = table.lookup(slips[i]);
+                break;
+            default:
+                table.lookup(slips.data(), mu.data(), count);
+                break;
+        }
+        benchmark::DoNotOptimize(mu.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    static const char* const labels[] = {"exp", "table", "table batch"};
+    state.SetLabel(labels[state.range(0)]);
+}
+BENCHMARK(BM_FrictionCurve)->DenseRange(0, 2);
+
+// Vehicle update per tire model. Arg 0: exact exponential, 1: exponential
+// table, 2: Pacejka table
+static void BM_VehicleUpdateTire(benchmark::State& state)
+{
+    static const char* const specs[] = {"exponential", "exponential", "pacejka"};
+    Vehicle vehicle = makeVehicle(4);
+    if (state.range(0) > 0) {
+        vehicle.setTireModel(std::make_shared<FrictionTable>(*TireModel::create(specs[state.range(0)])));
+    }
+
+    for (auto _ : state) {
+        vehicle.update(kDt);
+        benchmark::DoNotOptimize(vehicle.getLinearSpeed());
+    }
+    state.SetItemsProcessed(state.iterations() * 4);
+    state.SetLabel(state.range(0) > 0 ? std::string(specs[state.range(0)]) + " table" : "exp");
+}
+BENCHMARK(BM_VehicleUpdateTire)->DenseRange(0, 2);
+
+// Fleet update through the table path (compare with BM_FleetUpdate)
+static void BM_FleetUpdateTable(benchmark::State& state)
+{
+    int numVehicles = static_cast<int>(state.range(0));
+    VehicleFleet fleet(numVehicles, 4, 20.0);
+    fleet.setTireModel(std::make_shared<FrictionTable>(PacejkaTireModel()));
+    for (int v = 0; v < numVehicles; v++) {
+        for (int w = 0; w < 4; w++) {
+            fleet.setDriveTorque(v, w, 50.0);
+        }
+    }
+
+    for (auto _ : state) {
+        fleet.update(kDt);
+        benchmark::DoNotOptimize(fleet.getLinearSpeed(0));
+    }
+    state.SetItemsProcessed(state.iterations() * numVehicles * 4);
+}
+BENCHMARK(BM_FleetUpdateTable)->RangeMultiplier(8)->Range(1, 4096);
+
+// Friction of both lanes of a sampled 1 km split-mu track (1 point per meter)
+// while moving 0.2 m per step. Arg 0: Cursor, 1: binary search per lookup
+static void BM_SurfaceLookup(benchmark::State& state)
+{
+    SurfaceProfile profile(2);
+    for (int i = 0; i <= 1000; i++) {
+        profile.addPoint(i, 0.6 + 0.4 * std::sin(0.05 * i), 0.6 + 0.4 * std::cos(0.07 * i));
+    }
+    SurfaceProfile::Cursor cursor(profile);
+    const bool useCursor = state.range(0) == 0;
+
+    double distance = 0.0;
+    for (auto _ : state) {
+        distance = (distance < 1000.0) ? distance + 0.2 : 0.0;
+        double left, right;
+        if (useCursor) {
+            cursor.seek(distance);
+            left  = cursor.mu(0);
+            right = cursor.mu(1);
+        } else {
+            left  = profile.at(distance, 0);
+            right = profile.at(distance, 1);
+        }
+        benchmark::DoNotOptimize(left);
+        benchmark::DoNotOptimize(right);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(useCursor ? "cursor" : "binary search");
+}
+BENCHMARK(BM_SurfaceLookup)->DenseRange(0, 1);
+
+// Whole rollouts on a uniform road (Arg 0) and a split-mu section (Arg 1);
+// items/s is physics steps/s
+static void BM_SurfaceRollout(benchmark::State& state)
+{
+    Scenario scenario;
+    scenario.initialSpeed = 20.0;
+    scenario.steps = 500;
+    if (state.range(0) == 1) {
+        scenario.surface = SurfaceProfile::create("split");
+    }
+
+    for (auto _ : state) {
+        ScenarioResult result = BatchSimulation::runScenario(scenario, 1, kDt);
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations() * scenario.steps);
+    state.SetLabel(scenario.surface ? "split" : "uniform");
+}
+BENCHMARK(BM_SurfaceRollout)->DenseRange(0, 1);
+
+// Wheel integrators on a stiff low-speed creep (0.5 m/s, 20 N·m drive), with
+// a fixed step (second arg 0) or adaptive substeps to 0.01 rad/s (1). The
+// vehicle restarts every 200 steps; items/s is wheel steps/s.
+static void BM_Integrator(benchmark::State& state)
+{
+    auto method = static_cast<Vehicle::Integrator>(state.range(0));
+    double tolerance = state.range(1) ? 0.01 : 0.0;
+    auto makeCreep = [&]() {
+        Vehicle vehicle(0.5, 4);
+        vehicle.setIntegrator(method, tolerance);
+        for (int i = 0; i < 4; i++) {
+            vehicle.setDriveTorque(i, 20.0);
+        }
+        return vehicle;
+    };
+
+    Vehicle vehicle = makeCreep();
+    long long substeps = 0;
+    int step = 0;
+    for (auto _ : state) {
+        if (++step == 200) {
+            vehicle = makeCreep();
+            step = 0;
+        }
+        vehicle.update(kDt);
+        substeps += vehicle.getSubsteps();
+        benchmark::DoNotOptimize(vehicle.getLinearSpeed());
+    }
+    state.SetItemsProcessed(state.iterations() * 4);
+    state.counters["substeps"] = (double)substeps / (4.0 * state.iterations());
+    state.SetLabel(Vehicle::integratorName(method));
+}
+BENCHMARK(BM_Integrator)->ArgsProduct({{0, 1, 2, 3}, {0, 1}});
+
+// Cost of FlightRecorder::record on the control path, with the writer
+// thread draining into the mapped file. A tight loop outruns the writer, so
+// "dropped" is the fraction of records that found the ring full.
+static void BM_FlightRecord(benchmark::State& state)
+{
+    const std::string path = "tc_bench_flight.tcfr";
+    Vehicle vehicle = makeVehicle(4);
+    FlightRecorder recorder;
+    if (!recorder.open(path, kDt, 1)) {
+        state.SkipWithError("cannot open flight recorder file");
+        return;
+    }
+
+    uint64_t step = 0;
+    for (auto _ : state) {
+        recorder.record(vehicle, 0, step, step * kDt);
+        step++;
+    }
+    recorder.close();
+    std::remove(path.c_str());
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["dropped"] = (double)recorder.recordsDropped() / std::max<uint64_t>(step, 1);
+}
+BENCHMARK(BM_FlightRecord);
+
+// End-to-end data generation; items/s is rows/s.
+// Arg 0: records discarded, 1: CSV file, 2: columnar binary file
+static void BM_GenerateData(benchmark::State& state)
+{
+    static const char* const formats[] = {"null", "csv", "bin"};
+    const std::string format = formats[state.range(0)];
+    const std::string path = "tc_bench_trace." + format;
+    const long long rows = 200000;
+
+    for (auto _ : state) {
+        std::unique_ptr<TraceSink> sink = format == "null"
+            ? std::make_unique<NullTraceSink>()
+            : TraceWriter::makeSink(format);
+        TraceWriter writer(std::move(sink));
+        if (!writer.open(path)) {
+            state.SkipWithError("cannot open trace file");
+            break;
+        }
+        benchmark::DoNotOptimize(generateData(writer, rows));
+        writer.close();
+    }
+    std::remove(path.c_str());
+
+    state.SetItemsProcessed(state.iterations() * rows);
+    state.SetLabel(format);
+}
+BENCHMARK(BM_GenerateData)->DenseRange(0, 2)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Sharded generation into a discarding sink; Arg: worker threads
+static void BM_GenerateDataThreads(benchmark::State& state)
+{
+    const int threads = static_cast<int>(state.range(0));
+    const long long rows = 1000000;
+
+    for (auto _ : state) {
+        TraceWriter writer(std::make_unique<NullTraceSink>());
+        writer.open("");
+        benchmark::DoNotOptimize(generateData(writer, rows, 42, threads));
+        writer.close();
+    }
+    state.SetItemsProcessed(state.iterations() * rows);
+    state.counters["threads"] = threads;
+}
+BENCHMARK(BM_GenerateDataThreads)->RangeMultiplier(2)->Range(1, 8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
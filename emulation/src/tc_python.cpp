@@ -0,0 +1,157 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "BatchSimulation.h"
+#include "DataGenerator.h"
+#include "TraceWriter.h"
+#include "TractionControl.h"
+#include "Vehicle.h"
+
+// tc_sim: the simulation core as a Python module, so training can generate
+// data in-process instead of going through data_generator and CSV files.
+//
+// fill_batch() writes rows straight into caller-owned float32 arrays (NumPy
+// arrays, or torch CPU tensors through tensor.numpy(), which shares memory)
+// with the GIL released. Arrays must already be C-contiguous float32; they
+// are never converted, since a converted copy would not be seen by the caller.
+
+namespace py = pybind11;
+
+namespace {
+
+using FloatArray = py::array_t<float, py::array::c_style>;
+
+const std::vector<std::string> kDefaultFeatures = {
+    "slip_ratio", "angular_velocity", "linear_speed",
+    "current_brake_torque", "current_drive_torque",
+    "speed_to_velocity_ratio", "excess_drive_torque", "slip_deviation"
+};
+const std::vector<std::string> kDefaultTargets = {"desired_drive_torque", "desired_brake_torque"};
+
+MemoryTraceSink::Output bindOutput(FloatArray& array, const std::vector<std::string>& columns,
+                                   py::ssize_t rows, const char* what)
+{
+    if (array.ndim() != 2 || array.shape(0) != rows || array.shape(1) != (py::ssize_t)columns.size()) {
+        throw std::invalid_argument(std::string(what) + " must have shape (rows, " +
+                                    std::to_string(columns.size()) + ")");
+    }
+
+    MemoryTraceSink::Output out;
+    out.data = array.mutable_data();  // throws if the array is read-only
+    for (const auto& name : columns) {
+        int index = MemoryTraceSink::columnIndex(name);
+        if (index < 0) {
+            throw std::invalid_argument("unknown column: " + name);
+        }
+        out.columns.push_back(index);
+    }
+    return out;
+}
+
+long long fillBatch(FloatArray features, FloatArray targets, std::uint64_t seed, int threads,
+                    const std::vector<std::string>& featureColumns,
+                    const std::vector<std::string>& targetColumns)
+{
+    py::ssize_t rows = features.ndim() > 0 ? features.shape(0) : 0;
+    std::vector<MemoryTraceSink::Output> outputs = {
+        bindOutput(features, featureColumns, rows, "features"),
+        bindOutput(targets, targetColumns, rows, "targets")
+    };
+
+    py::gil_scoped_release release;
+
+    TraceWriter writer(std::make_unique<MemoryTraceSink>(std::move(outputs), (std::size_t)rows));
+    writer.open("");
+    long long written = generateData(writer, rows, seed, threads);
+    if (!writer.close()) {
+        throw std::runtime_error("generating the batch failed");
+    }
+    return written;
+}
+
+} // namespace
+
+PYBIND11_MODULE(tc_sim, m)
+{
+    m.doc() = "Traction control simulation core (Vehicle, TractionControl, batch rollouts, data generation)";
+
+    py::class_<Vehicle::Wheel>(m, "Wheel")
+        .def_readonly("angular_velocity", &Vehicle::Wheel::angularVelocity)
+        .def_readonly("brake_torque", &Vehicle::Wheel::brakeTorque)
+        .def_readonly("drive_torque", &Vehicle::Wheel::driveTorque)
+        .def_readonly("rotation_angle", &Vehicle::Wheel::rotationAngle);
+
+    py::enum_<Vehicle::Integrator>(m, "Integrator")
+        .value("EULER", Vehicle::Integrator::Euler)
+        .value("SEMI_IMPLICIT_EULER", Vehicle::Integrator::SemiImplicitEuler)
+        .value("RK4", Vehicle::Integrator::RK4)
+        .value("IMPLICIT", Vehicle::Integrator::Implicit);
+
+    py::class_<Vehicle>(m, "Vehicle")
+        .def(py::init<double, int>(), py::arg("initial_speed"), py::arg("num_wheels") = 4)
+        .def("update", &Vehicle::update, py::arg("dt"))
+        .def("compute_slip_ratio", &Vehicle::computeSlipRatio, py::arg("wheel"))
+        .def("set_brake_torque", &Vehicle::setBrakeTorque, py::arg("wheel"), py::arg("torque"))
+        .def("set_drive_torque", &Vehicle::setDriveTorque, py::arg("wheel"), py::arg("torque"))
+        .def("set_friction", &Vehicle::setFriction, py::arg("friction"))
+        .def("set_wheel_friction", &Vehicle::setWheelFriction, py::arg("wheel"), py::arg("friction"))
+        .def("set_integrator", &Vehicle::setIntegrator, py::arg("method"),
+             py::arg("tolerance") = 0.0, py::arg("max_substeps") = 64)
+        .def_property_readonly("substeps", &Vehicle::getSubsteps)
+        .def_property_readonly("linear_speed", &Vehicle::getLinearSpeed)
+        .def_property_readonly("wheels", &Vehicle::getWheels);
+
+    py::class_<TractionGains>(m, "TractionGains")
+        .def(py::init<>())
+        .def_readwrite("max_brake_torque", &TractionGains::maxBrakeTorque)
+        .def_readwrite("max_drive_torque", &TractionGains::maxDriveTorque)
+        .def_readwrite("brake_ramp_rate", &TractionGains::brakeRampRate)
+        .def_readwrite("drive_ramp_rate", &TractionGains::driveRampRate);
+
+    py::class_<TractionControl>(m, "TractionControl")
+        .def(py::init<double, const TractionGains&>(),
+             py::arg("desired_slip") = 0.1, py::arg("gains") = TractionGains())
+        .def("update", &TractionControl::update, py::arg("vehicle"), py::arg("dt"));
+
+    py::class_<Scenario>(m, "Scenario")
+        .def(py::init<>())
+        .def_readwrite("friction", &Scenario::friction)
+        .def_readwrite("initial_speed", &Scenario::initialSpeed)
+        .def_readwrite("desired_slip", &Scenario::desiredSlip)
+        .def_readwrite("steps", &Scenario::steps)
+        .def_readwrite("num_wheels", &Scenario::numWheels)
+        .def_readwrite("friction_noise", &Scenario::frictionNoise)
+        .def_readwrite("gains", &Scenario::gains)
+        .def_readwrite("integrator", &Scenario::integrator)
+        .def_readwrite("integrator_tolerance", &Scenario::integratorTolerance);
+
+    py::class_<ScenarioResult>(m, "ScenarioResult")
+        .def_readonly("final_speed", &ScenarioResult::finalSpeed)
+        .def_readonly("distance", &ScenarioResult::distance)
+        .def_readonly("mean_slip_error", &ScenarioResult::meanSlipError)
+        .def_readonly("max_abs_slip", &ScenarioResult::maxAbsSlip)
+        .def_readonly("stopping_distance", &ScenarioResult::stoppingDistance);
+
+    py::class_<BatchSimulation>(m, "BatchSimulation")
+        .def(py::init<int, std::uint64_t, double>(),
+             py::arg("threads") = 0, py::arg("seed") = 0, py::arg("dt") = 0.01)
+        .def("run", py::overload_cast<const std::vector<Scenario>&>(&BatchSimulation::run),
+             py::arg("scenarios"), py::call_guard<py::gil_scoped_release>())
+        .def_property_readonly("threads", &BatchSimulation::getNumThreads);
+
+    m.def("column_names", &MemoryTraceSink::columnNames,
+          "Names of the columns fill_batch can write");
+
+    m.def("fill_batch", &fillBatch,
+          py::arg("features").noconvert(), py::arg("targets").noconvert(),
+          py::arg("seed"), py::arg("threads") = 1,
+          py::arg("feature_columns") = kDefaultFeatures,
+          py::arg("target_columns") = kDefaultTargets,
+          "Fill float32 arrays of shape (rows, columns) in place with freshly simulated rows "
+          "(same scenarios and columns as data_generator --seed). Returns the number of rows.");
+}
@@ -0,0 +1,118 @@
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "GainTuner.h"
+
+// Prints one row of the result tables
+static void printRow(const TuningResult& r)
+{
+    std::cout << std::setw(12) << r.slipError
+              << std::setw(12) << r.stoppingDistance
+              << std::setw(12) << r.gains.maxBrakeTorque
+              << std::setw(12) << r.gains.maxDriveTorque
+              << std::setw(12) << r.gains.brakeRampRate
+              << std::setw(12) << r.gains.driveRampRate << '\n';
+}
+
+static bool writeCsv(const std::string& path, const std::vector<TuningResult>& results)
+{
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Error opening file for writing: " << path << std::endl;
+        return false;
+    }
+    file << "slip_error,stopping_distance,max_brake_torque,max_drive_torque,brake_ramp_rate,drive_ramp_rate\n";
+    for (const auto& r : results) {
+        file << r.slipError << ',' << r.stoppingDistance << ','
+             << r.gains.maxBrakeTorque << ',' << r.gains.maxDriveTorque << ','
+             << r.gains.brakeRampRate << ',' << r.gains.driveRampRate << '\n';
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    std::string method = "cmaes";
+    int threads     = 0;    // 0 => all hardware threads
+    unsigned long long seed = 0;
+    double noise    = 0.0;
+    int points      = 6;    // grid: values per gain
+    int samples     = 1000; // random
+    int generations = 40;   // cmaes
+    int population  = 0;    // cmaes, 0 => default
+    int runs        = 5;    // cmaes, objective weightings
+    std::string csvPath;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--method" && i + 1 < argc) {
+            method = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--noise" && i + 1 < argc) {
+            noise = std::atof(argv[++i]);
+        } else if (arg == "--points" && i + 1 < argc) {
+            points = std::atoi(argv[++i]);
+        } else if (arg == "--samples" && i + 1 < argc) {
+            samples = std::atoi(argv[++i]);
+        } else if (arg == "--generations" && i + 1 < argc) {
+            generations = std::atoi(argv[++i]);
+        } else if (arg == "--population" && i + 1 < argc) {
+            population = std::atoi(argv[++i]);
+        } else if (arg == "--runs" && i + 1 < argc) {
+            runs = std::atoi(argv[++i]);
+        } else if (arg == "--csv" && i + 1 < argc) {
+            csvPath = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--method grid|random|cmaes] [--threads N] [--seed S] [--noise SIGMA]"
+                      << " [--points N] [--samples N] [--generations N] [--population N] [--runs N]"
+                      << " [--csv FILE]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    GainTuner tuner(threads, seed, noise);
+    TuningResult defaults = tuner.evaluate({TractionGains()})[0];
+
+    std::vector<TuningResult> results;
+    if (method == "grid") {
+        results = tuner.gridSearch(points);
+    } else if (method == "random") {
+        results = tuner.randomSearch(samples);
+    } else if (method == "cmaes") {
+        results = tuner.cmaEs(generations, population, runs);
+    } else {
+        std::cerr << "Unknown method: " << method << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto& stats = tuner.totalStats();
+    std::cout << "Method: " << method
+              << " | candidates: " << results.size()
+              << " | rollouts: " << stats.scenarios
+              << " | threads: " << stats.threads
+              << " | time: " << stats.seconds << " s"
+              << " | " << stats.scenariosPerSecond << " rollouts/s" << std::endl;
+
+    std::cout << std::fixed << std::setprecision(4)
+              << std::setw(12) << "slip err" << std::setw(12) << "stop m"
+              << std::setw(12) << "max brake" << std::setw(12) << "max drive"
+              << std::setw(12) << "brake ramp" << std::setw(12) << "drive ramp" << '\n';
+    std::cout << "Default gains:\n";
+    printRow(defaults);
+    std::cout << "Pareto front:\n";
+    for (const auto& r : GainTuner::paretoFront(results)) {
+        printRow(r);
+    }
+
+    if (!csvPath.empty() && !writeCsv(csvPath, results)) {
+        return EXIT_FAILURE;
+    }
+    return 0;
+}